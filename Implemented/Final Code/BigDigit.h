@@ -0,0 +1,62 @@
+#ifndef BIGDIGIT_H
+#define BIGDIGIT_H
+
+#include "Glyph.h"
+
+// Two row tall, three column wide numerals built from 7 CGRAM segments.
+// Digits are drawn into the framebuffer, so when a number changes only the
+// digits that differ go out over I2C. The 0-100 in steps of 20 the kiosk
+// shows needs all 7 segments for 20 and 80, leaving one slot for a fruit
+// icon. Whatever else was in CGRAM (other fruit icons, bar cells) gets
+// evicted, and uploads are written to the display straight away
+
+const uint8_t BIGDIGIT_SEGMENTS[7][8] PROGMEM = {
+    {0x07, 0x0F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}, // 0 Left top
+    {0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00}, // 1 Upper bar
+    {0x1C, 0x1E, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}, // 2 Right top
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x0F, 0x07}, // 3 Left bottom
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F}, // 4 Lower bar
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1E, 0x1C}, // 5 Right bottom
+    {0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x1F}, // 6 Upper and middle bar
+};
+
+// Cells of each digit, top row then bottom row: 0-6 = segment above,
+// 0xFF = full block from the character ROM, ' ' = blank
+const uint8_t BIGDIGIT_CELLS[10][6] PROGMEM = {
+    {0,    1,    2,    3,    4,    5},    // 0
+    {1,    2,    ' ',  4,    0xFF, 4},    // 1
+    {6,    6,    2,    3,    4,    4},    // 2
+    {6,    6,    2,    4,    4,    5},    // 3
+    {3,    4,    0xFF, ' ',  ' ',  0xFF}, // 4
+    {0xFF, 6,    6,    4,    4,    5},    // 5
+    {0,    6,    6,    3,    4,    5},    // 6
+    {1,    1,    2,    ' ',  ' ',  0xFF}, // 7
+    {0,    6,    2,    3,    4,    5},    // 8
+    {0,    6,    2,    ' ',  ' ',  0xFF}, // 9
+};
+
+// Draw one big digit with its top left cell at (col, row), 0xFF = blank
+void lcd_fb_bigDigit(uint8_t col, uint8_t row, uint8_t digit) {
+    for (uint8_t r = 0; r < 2; r++) {
+        lcd_fb_setCursor(col, row + r);
+        for (uint8_t c = 0; c < 3; c++) {
+            uint8_t cell = digit < 10 ? pgm_read_byte(&BIGDIGIT_CELLS[digit][r * 3 + c]) : ' ';
+            lcd_fb_write(cell < 7 ? glyph_use(BIGDIGIT_SEGMENTS[cell]) : cell);
+        }
+    }
+}
+
+// Draw a number right aligned in `digits` big digits from (col, row), one
+// blank column between digits and leading zeros left blank
+void lcd_fb_bigNumber(uint8_t col, uint8_t row, uint8_t digits, uint16_t value) {
+    for (uint8_t i = digits; i-- > 0; ) {
+        uint8_t digit = value % 10;
+        if (value == 0 && i != digits - 1) {
+            digit = 0xFF; // Leading zero
+        }
+        lcd_fb_bigDigit(col + i * 4, row, digit);
+        value /= 10;
+    }
+}
+
+#endif // BIGDIGIT_H
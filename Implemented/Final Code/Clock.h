@@ -0,0 +1,84 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+// System time from a 1ms Timer0 tick (CTC, F_CPU/64). Timer1 stays with
+// the pumps (Dispense.h). Waits are written as "has this much time passed
+// since then" checks in the loops, so input, the LCD and the debug report
+// keep running while time passes. Times are uint32_t ms since power up and
+// wrap after ~49 days; the helpers below are correct across the wrap
+
+#define CLOCK_TICKS_PER_MS (F_CPU / 64 / 1000) // Timer0 counts at F_CPU/64
+#define CLOCK_US_PER_TICK (64000000UL / F_CPU)
+
+#if (F_CPU / 64) % 1000 || CLOCK_TICKS_PER_MS > 256 || 64000000UL % F_CPU
+#error "Clock.h needs F_CPU a multiple of 64kHz that divides 64MHz, up to 16MHz"
+#endif
+
+volatile uint32_t clock_ms = 0;
+
+// Start the 1ms Timer0 tick
+void clock_init(void) {
+    TCCR0A = (1 << WGM01);               // CTC
+    TCCR0B = (1 << CS01) | (1 << CS00);  // F_CPU/64
+    OCR0A = CLOCK_TICKS_PER_MS - 1;
+    TIMSK0 |= (1 << OCIE0A);
+}
+
+// Milliseconds since power up
+uint32_t clock_millis(void) {
+    uint32_t ms;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = clock_ms;
+    }
+    return ms;
+}
+
+// Time since power up in Timer0 ticks (4us at 16MHz), wraps after ~4.7h.
+// Safe to call from an ISR
+uint32_t clock_ticks(void) {
+    uint32_t ms;
+    uint8_t count;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = clock_ms;
+        count = TCNT0;
+        if ((TIFR0 & (1 << OCF0A)) && count < CLOCK_TICKS_PER_MS / 2) {
+            ms++; // Tick is pending, TCNT0 already wrapped
+        }
+    }
+    return ms * CLOCK_TICKS_PER_MS + count;
+}
+
+// Microseconds since power up, CLOCK_US_PER_TICK resolution
+uint32_t clock_micros(void) {
+    return clock_ticks() * CLOCK_US_PER_TICK;
+}
+
+// Milliseconds from `start` (a clock_millis() value) to now
+uint32_t clock_since(uint32_t start) {
+    return clock_millis() - start;
+}
+
+// 1 once `ms` milliseconds have passed since `start`
+uint8_t clock_elapsed(uint32_t start, uint32_t ms) {
+    return clock_since(start) >= ms;
+}
+
+// Timeouts: clock_deadline(500) now, then clock_expired(d) turns 1 half a
+// second later. Deadlines up to ~24 days ahead compare correctly
+uint32_t clock_deadline(uint32_t ms) {
+    return clock_millis() + ms;
+}
+
+uint8_t clock_expired(uint32_t deadline) {
+    return (int32_t)(clock_millis() - deadline) >= 0;
+}
+
+ISR(TIMER0_COMPA_vect) {
+    clock_ms++;
+}
+
+#endif // CLOCK_H
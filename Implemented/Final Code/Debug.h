@@ -0,0 +1,148 @@
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <avr/pgmspace.h>
+#include "Format.h"
+
+// Debug channel: transmit only serial, 38400 8N1, on PD4. The USART pins
+// PD0/PD1 drive relays 1 and 2, so the bits are clocked out by hand, one
+// per Timer2 compare interrupt (a few us each), from a small buffer. The
+// debug_* calls only fill the buffer; a caller that must not wait checks
+// debug_room() first. With DEBUG_UART 0 (the default) every debug_* call
+// compiles to nothing
+#ifndef DEBUG_UART
+#define DEBUG_UART 0
+#endif
+
+#define DEBUG_TX_BIT PD4
+#define DEBUG_BAUD 38400
+#define DEBUG_TX_SIZE 64       // Buffer, a power of two
+#define DEBUG_TIMER_TOP ((F_CPU / 8 + DEBUG_BAUD / 2) / DEBUG_BAUD - 1) // Timer2 at F_CPU/8
+
+#if DEBUG_UART && (DEBUG_TIMER_TOP > 255 || DEBUG_TIMER_TOP < 10)
+#error "Debug.h cannot clock 38400 baud from Timer2 at this F_CPU"
+#endif
+
+#if DEBUG_UART
+char debug_tx[DEBUG_TX_SIZE];
+volatile uint8_t debug_tx_head = 0;    // Next free byte, written by debug_putc()
+volatile uint8_t debug_tx_tail = 0;    // Next byte to send, moved on by the ISR
+uint16_t debug_tx_frame = 0;           // Bits of the byte being sent, 0 = none
+#endif
+
+// Idle the TX line (high) and set up the bit clock, stopped until there
+// is something to send
+void debug_init(void) {
+#if DEBUG_UART
+    PORTD |= (1 << DEBUG_TX_BIT);
+    DDRD |= (1 << DEBUG_TX_BIT);
+    TCCR2A = (1 << WGM21);            // CTC
+    TCCR2B = (1 << CS21);             // F_CPU/8
+    OCR2A = DEBUG_TIMER_TOP;
+#endif
+}
+
+// Bytes debug_putc() can take without waiting
+uint8_t debug_room(void) {
+#if DEBUG_UART
+    return (uint8_t)(debug_tx_tail - debug_tx_head - 1) % DEBUG_TX_SIZE;
+#else
+    return 0xFF;
+#endif
+}
+
+// Queue one byte, waits for the buffer if it is full
+void debug_putc(char c) {
+#if DEBUG_UART
+    uint8_t next = (debug_tx_head + 1) % DEBUG_TX_SIZE;
+    while (next == debug_tx_tail) {
+        // Full, the ISR frees a byte every ~260us
+    }
+    debug_tx[debug_tx_head] = c;
+    debug_tx_head = next;
+    TIMSK2 |= (1 << OCIE2A);          // Start the bit clock if it was idle
+#else
+    (void)c;
+#endif
+}
+
+// Send a string stored in flash
+void debug_print_P(const char *str) {
+#if DEBUG_UART
+    char c;
+    while ((c = pgm_read_byte(str++))) {
+        debug_putc(c);
+    }
+#else
+    (void)str;
+#endif
+}
+
+// Send a number in decimal
+void debug_uint(uint32_t value) {
+#if DEBUG_UART
+    char digits[11];
+    fmt_u32(digits, value, 0);
+    for (char *d = digits; *d; d++) {
+        debug_putc(*d);
+    }
+#else
+    (void)value;
+#endif
+}
+
+// Send " name=value", the unit of every debug line
+void debug_field_P(const char *name, uint32_t value) {
+#if DEBUG_UART
+    debug_putc(' ');
+    debug_print_P(name);
+    debug_putc('=');
+    debug_uint(value);
+#else
+    (void)name;
+    (void)value;
+#endif
+}
+
+// Send " name=a/b/c...", e.g. the buckets of a histogram
+void debug_list_P(const char *name, const uint16_t *values, uint8_t count) {
+#if DEBUG_UART
+    debug_putc(' ');
+    debug_print_P(name);
+    for (uint8_t i = 0; i < count; i++) {
+        debug_putc(i ? '/' : '=');
+        debug_uint(values[i]);
+    }
+#else
+    (void)name;
+    (void)values;
+    (void)count;
+#endif
+}
+
+#if DEBUG_UART
+// One bit per compare match: start bit, 8 data bits LSB first, stop bit.
+// The bit clock stops when the buffer runs dry
+ISR(TIMER2_COMPA_vect) {
+    if (!debug_tx_frame) {
+        uint8_t tail = debug_tx_tail;
+        if (tail == debug_tx_head) {
+            TIMSK2 &= ~(1 << OCIE2A);
+            return;
+        }
+        debug_tx_frame = ((uint16_t)(uint8_t)debug_tx[tail] << 1) | 0x200; // Start bit 0, stop bit 1
+        debug_tx_tail = (tail + 1) % DEBUG_TX_SIZE;
+    }
+    if (debug_tx_frame & 1) {
+        PORTD |= (1 << DEBUG_TX_BIT);
+    } else {
+        PORTD &= ~(1 << DEBUG_TX_BIT);
+    }
+    debug_tx_frame >>= 1;
+}
+#endif
+
+#endif // DEBUG_H
@@ -0,0 +1,93 @@
+#ifndef DISPENSE_H
+#define DISPENSE_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+// Pump on-time is counted by Timer1 (1ms CTC tick) and the relay is
+// switched off from its ISR, so whatever the main loop does while a pump
+// runs (LCD redraws, input polling) cannot stretch the pour. Relays are on
+// PORTD and active low.
+//
+// Timer1 runs free for dispense_timestamp(). A pour counts its
+// milliseconds on compare B, set one count behind where the counter was
+// when the pump went on. A match is flagged on the timer clock after the
+// counter reaches OCR1B (writing OCR1B does not block it), so the first
+// match is a whole millisecond away, less at most one 4us tick
+
+#define DISPENSE_TICKS_PER_MS (F_CPU / 64 / 1000) // Timer1 counts at F_CPU/64
+
+volatile uint16_t dispense_remaining = 0; // ms left on the running pump
+volatile uint8_t dispense_motor = 0;      // PORTD bit of the running pump
+volatile uint32_t dispense_ms = 0;        // Free running ms count, for timestamps
+
+// Start the 1ms Timer1 tick
+void dispense_init(void) {
+    TCCR1A = 0;
+    TCCR1B = (1 << WGM12) | (1 << CS11) | (1 << CS10); // CTC, F_CPU/64
+    OCR1A = DISPENSE_TICKS_PER_MS - 1;
+    TIMSK1 |= (1 << OCIE1A);
+}
+
+// Switch a pump on for `ms` milliseconds, it goes off by itself
+void dispense_start(uint8_t motor, uint16_t ms) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint16_t count = TCNT1;
+        OCR1B = count ? count - 1 : OCR1A;  // Count from here, 1ms per match
+        TIFR1 = (1 << OCF1B);
+        TIMSK1 |= (1 << OCIE1B);
+        dispense_motor = motor;
+        dispense_remaining = ms;
+        PORTD &= ~(1 << motor);   // Turn on the motor
+    }
+}
+
+// Milliseconds left on the running pump, 0 once it is off
+uint16_t dispense_left(void) {
+    uint16_t ms;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = dispense_remaining;
+    }
+    return ms;
+}
+
+// Switch the running pump off early
+void dispense_stop(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        dispense_remaining = 0;
+        TIMSK1 &= ~(1 << OCIE1B);
+        PORTD |= (1 << dispense_motor);
+    }
+}
+
+// Time since power up in Timer1 ticks (4us at 16MHz), wraps after ~4.7h.
+// Differences between two stamps are correct across the wrap
+uint32_t dispense_timestamp(void) {
+    uint32_t ms;
+    uint16_t count;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = dispense_ms;
+        count = TCNT1;
+        if ((TIFR1 & (1 << OCF1A)) && count < DISPENSE_TICKS_PER_MS / 2) {
+            ms++; // Tick is pending, TCNT1 already wrapped
+        }
+    }
+    return ms * DISPENSE_TICKS_PER_MS + count;
+}
+
+// 1ms tick for timestamps
+ISR(TIMER1_COMPA_vect) {
+    dispense_ms++;
+}
+
+// 1ms after the pump went on and every 1ms since: counts down the running
+// pump and switches its relay off on time
+ISR(TIMER1_COMPB_vect) {
+    if (dispense_remaining && --dispense_remaining == 0) {
+        PORTD |= (1 << dispense_motor); // Turn off the motor after delay
+        TIMSK1 &= ~(1 << OCIE1B);
+    }
+}
+
+#endif // DISPENSE_H
@@ -0,0 +1,93 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <avr/pgmspace.h>
+
+// Numbers to text for the screens, in place of snprintf(). The avr-libc
+// printf machinery (vfprintf, fputc, __ultoa_invert) is ~1.5KB of flash and
+// parses the format string on every call; these split a number into digits
+// by subtracting powers of ten, no division. Every fmt_* writes at buf,
+// NUL terminates and returns a pointer to the NUL, so calls can be chained.
+// A width wider than the text pads it with spaces on the left, like %3u
+
+static const uint16_t fmt_pow10[] PROGMEM = {10000, 1000, 100, 10};
+
+// The five decimal digits of value, most significant first
+void fmt_split(char *digits, uint16_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        uint16_t p = pgm_read_word(&fmt_pow10[i]);
+        char d = '0';
+        while (value >= p) {
+            value -= p;
+            d++;
+        }
+        digits[i] = d;
+    }
+    digits[4] = '0' + value;
+}
+
+// Fixed point: value in units of 10^-decimals (0-4), e.g. 1234 with 2
+// decimals is "12.34" and 5 is "0.05"
+char *fmt_fixed(char *buf, uint16_t value, uint8_t decimals, uint8_t width) {
+    char digits[5];
+    uint8_t first = 0;
+    fmt_split(digits, value);
+    while (first < 4 - decimals && digits[first] == '0') {
+        first++; // Leading zeros, but keep one before the point
+    }
+    for (uint8_t len = 5 - first + (decimals != 0); len < width; len++) {
+        *buf++ = ' ';
+    }
+    for (uint8_t i = first; i < 5; i++) {
+        if (decimals && i == 5 - decimals) {
+            *buf++ = '.';
+        }
+        *buf++ = digits[i];
+    }
+    *buf = '\0';
+    return buf;
+}
+
+// Unsigned integer, u8 values included
+char *fmt_u16(char *buf, uint16_t value, uint8_t width) {
+    return fmt_fixed(buf, value, 0, width);
+}
+
+// The last `count` digits (1-5) of value with leading zeros, like %02u
+char *fmt_zero(char *buf, uint16_t value, uint8_t count) {
+    char digits[5];
+    fmt_split(digits, value);
+    for (uint8_t i = 5 - count; i < 5; i++) {
+        *buf++ = digits[i];
+    }
+    *buf = '\0';
+    return buf;
+}
+
+// Values up to 655359999, for timings in microseconds and the like
+char *fmt_u32(char *buf, uint32_t value, uint8_t width) {
+    if (value <= 0xFFFF) {
+        return fmt_u16(buf, value, width);
+    }
+    buf = fmt_u16(buf, value / 10000, width > 4 ? width - 4 : 0);
+    return fmt_zero(buf, value % 10000, 4);
+}
+
+// "42%"
+char *fmt_percent(char *buf, uint16_t value, uint8_t width) {
+    buf = fmt_u16(buf, value, width);
+    *buf++ = '%';
+    *buf = '\0';
+    return buf;
+}
+
+// "250ml"
+char *fmt_ml(char *buf, uint16_t value, uint8_t width) {
+    buf = fmt_u16(buf, value, width);
+    *buf++ = 'm';
+    *buf++ = 'l';
+    *buf = '\0';
+    return buf;
+}
+
+#endif // FORMAT_H
@@ -0,0 +1,112 @@
+#ifndef GLYPH_H
+#define GLYPH_H
+
+#include "LCDBuffer.h"
+
+// The HD44780 has 8 CGRAM slots for custom 5x8 characters. A glyph is an
+// 8 byte bitmap in flash and is identified by its flash address.
+// glyph_use() hands out the character code for a glyph and only uploads it
+// (9 LCD writes) when it is not already in a slot
+#define GLYPH_SLOTS 8
+
+uint8_t glyph_lru[GLYPH_SLOTS];         // Slots, most recently used first
+uint16_t glyph_uploads = 0;             // CGRAM uploads done so far
+
+// Partial progress bar cells, GLYPH_BAR[n] has n+1 columns lit from the
+// left. A full cell is 0xFF in the character ROM
+const uint8_t GLYPH_BAR[4][8] PROGMEM = {
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+    {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+    {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+};
+
+// Left/right arrows are 0x7F/0x7E in the character ROM, up/down are not
+const uint8_t GLYPH_ARROW_UP[8] PROGMEM   = {0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04, 0x00};
+const uint8_t GLYPH_ARROW_DOWN[8] PROGMEM = {0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00};
+
+// Forget what CGRAM holds, call after initialize(). lcd_cgram (LCDBuffer.h)
+// is the slot table, so a restarted display gets its glyphs back
+void glyph_reset(void) {
+    for (uint8_t i = 0; i < GLYPH_SLOTS; i++) {
+        lcd_cgram[i] = 0;
+        glyph_lru[i] = i;
+    }
+}
+
+// Move a slot to the front of the LRU order
+void glyph_touch(uint8_t slot) {
+    uint8_t i = 0;
+    while (glyph_lru[i] != slot) {
+        i++;
+    }
+    for (; i > 0; i--) {
+        glyph_lru[i] = glyph_lru[i - 1];
+    }
+    glyph_lru[0] = slot;
+}
+
+// 1 if the slot's character code is on the LCD or in the frame being drawn.
+// Codes 0x00-0x07 and 0x08-0x0F both show CGRAM slots 0-7
+uint8_t glyph_on_screen(uint8_t slot) {
+    const uint8_t *frame = (const uint8_t *)lcd_frame;
+    const uint8_t *shadow = (const uint8_t *)lcd_shadow;
+    for (uint8_t i = 0; i < LCD_ROWS * LCD_COLS; i++) {
+        if ((frame[i] & 0xF7) == slot || (shadow[i] & 0xF7) == slot) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Write a glyph's 8 rows into a CGRAM slot
+void glyph_upload(uint8_t slot, const uint8_t *glyph) {
+    lcd_fb_upload(slot, glyph);
+    glyph_uploads++;
+}
+
+// Character code (0x08-0x0F, so it can sit in a string) that shows the
+// glyph. On a miss the least recently used slot that is not on screen is
+// replaced; only if all 8 are visible does the oldest one get overwritten
+uint8_t glyph_use(const uint8_t *glyph) {
+    uint8_t slot;
+
+    for (slot = 0; slot < GLYPH_SLOTS; slot++) {
+        if (lcd_cgram[slot] == glyph) {
+            glyph_touch(slot);
+            return 0x08 | slot;
+        }
+    }
+
+    slot = glyph_lru[GLYPH_SLOTS - 1];
+    for (uint8_t i = GLYPH_SLOTS; i-- > 0; ) {
+        uint8_t candidate = glyph_lru[i];
+        if (!lcd_cgram[candidate] || !glyph_on_screen(candidate)) {
+            slot = candidate;
+            break;
+        }
+    }
+
+    glyph_upload(slot, glyph);
+    glyph_touch(slot);
+    return 0x08 | slot;
+}
+
+// Draw a bar `cells` characters wide at the frame cursor, filled to
+// value/max in fifth-of-a-cell steps
+void lcd_fb_bar(uint8_t cells, uint16_t value, uint16_t max) {
+    uint16_t steps = max ? (uint32_t)value * cells * 5 / max : 0;
+    for (uint8_t i = 0; i < cells; i++) {
+        if (steps >= 5) {
+            lcd_fb_write(0xFF);
+            steps -= 5;
+        } else if (steps) {
+            lcd_fb_write(glyph_use(GLYPH_BAR[steps - 1]));
+            steps = 0;
+        } else {
+            lcd_fb_write(' ');
+        }
+    }
+}
+
+#endif // GLYPH_H
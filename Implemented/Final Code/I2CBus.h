@@ -0,0 +1,503 @@
+#ifndef I2CBUS_H
+#define I2CBUS_H
+
+#include <avr/io.h>
+#include <util/delay.h>
+#include <util/atomic.h>
+#include <compat/twi.h>
+
+// The TWI bus the display shares with the other devices on it (EEPROM, I/O
+// expanders for pumps and sensors). Blocking i2c_* primitives for start up,
+// probing and bus recovery, and with LCD_TWI_ASYNC a queue of prioritized
+// transactions that TWI_vect (in LCD.h) runs between the display's bytes.
+// LCD.h includes this file and sets LCD_TWI_ASYNC first
+
+// Requested SCL rate. TWBR and the prescaler are worked out from F_CPU
+// below, so the bus runs at this speed (or just under it) on any clock.
+// Above 400kHz the streamed nibbles would outrun the HD44780
+#ifndef I2C_SCL_HZ
+#define I2C_SCL_HZ 400000UL
+#endif
+
+#ifndef F_CPU
+#error "F_CPU must be defined before I2CBus.h"
+#endif
+
+// Longest any single TWI wait may spin before the bus counts as hung, about
+// two byte times plus margin (a little longer in practice at slow F_CPU, the
+// poll loop itself takes a few cycles per microsecond)
+#ifndef I2C_TWI_TIMEOUT_US
+#define I2C_TWI_TIMEOUT_US (18000000UL / I2C_SCL_HZ + 50)
+#endif
+
+#if I2C_SCL_HZ > 400000UL
+#error "I2C_SCL_HZ above 400kHz, the PCF8574 and the nibble timing cannot keep up"
+#endif
+
+// SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS). Everything is rounded up so the
+// bus never runs faster than asked
+#define I2C_TWI_CYCLES ((F_CPU + I2C_SCL_HZ - 1) / I2C_SCL_HZ) // CPU cycles per SCL period
+#if I2C_TWI_CYCLES < 16
+#error "I2C_SCL_HZ unreachable, the TWI needs at least 16 CPU cycles per SCL period"
+#endif
+#define I2C_TWI_DIV ((I2C_TWI_CYCLES - 16 + 1) / 2)              // TWBR * 4^TWPS
+
+#if I2C_TWI_DIV <= 255
+#define I2C_TWPS 0
+#define I2C_TWBR I2C_TWI_DIV
+#elif I2C_TWI_DIV <= 255UL * 4
+#define I2C_TWPS 1
+#define I2C_TWBR ((I2C_TWI_DIV + 3) / 4)
+#elif I2C_TWI_DIV <= 255UL * 16
+#define I2C_TWPS 2
+#define I2C_TWBR ((I2C_TWI_DIV + 15) / 16)
+#elif I2C_TWI_DIV <= 255UL * 64
+#define I2C_TWPS 3
+#define I2C_TWBR ((I2C_TWI_DIV + 63) / 64)
+#else
+#error "I2C_SCL_HZ unreachable, too slow for F_CPU even with the /64 prescaler"
+#endif
+
+// 1 = keep the i2c_stat_* and lcd_stat_* counters (a few cycles per byte).
+// Latency and busy time are only measured when the application supplies
+// I2C_CLOCK() (a free running uint32_t count) and I2C_CLOCK_CYCLES (CPU
+// cycles per count)
+#ifndef I2C_STATS
+#define I2C_STATS 1
+#endif
+
+#if I2C_STATS
+#define I2C_STAT(expr) expr
+#else
+#define I2C_STAT(expr)
+#endif
+
+#if I2C_STATS && defined(I2C_CLOCK)
+#define I2C_TIMED 1
+#else
+#define I2C_TIMED 0
+#endif
+
+// Fault counters, for judging how flaky the bus is
+uint16_t i2c_timeouts = 0;       // TWI waits that gave up
+uint16_t i2c_recoveries = 0;     // Times SCL was clocked by hand to free SDA
+
+// Also counted in TWI_vect, read them with interrupts off
+volatile uint32_t i2c_stat_bytes = 0; // Bytes on the bus, addresses included
+volatile uint16_t i2c_stat_nacks = 0; // Address or data bytes not acknowledged
+
+// I2C initialization
+void i2c_init(void) {
+    TWSR = I2C_TWPS; // Prescaler bits, from I2C_SCL_HZ and F_CPU
+    TWBR = I2C_TWBR; // 0x0C for 400kHz at 16MHz
+    TWCR = (1 << TWEN); // Enable TWI (I2C)
+}
+
+// Wait for the TWI to finish the current step, 0 = done, 1 = timed out
+uint8_t i2c_wait(void) {
+    for (uint16_t t = I2C_TWI_TIMEOUT_US; t; t--) {
+        if (TWCR & (1 << TWINT)) {
+            return 0;
+        }
+        _delay_us(1);
+    }
+    i2c_timeouts++;
+    return 1;
+}
+
+// Send START condition on I2C, 0 = sent
+uint8_t i2c_start(void) {
+    TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWINT); // Send START condition
+    if (i2c_wait()) {
+        return 1;
+    }
+    return (TWSR & 0xF8) != TW_START && (TWSR & 0xF8) != TW_REP_START;
+}
+
+// Send STOP condition on I2C
+void i2c_stop(void) {
+    TWCR = (1 << TWSTO) | (1 << TWEN) | (1 << TWINT); // Send STOP condition
+}
+
+// Wait for a STOP to leave the bus, 0 = done, 1 = timed out
+uint8_t i2c_wait_stop(void) {
+    for (uint16_t t = I2C_TWI_TIMEOUT_US; t; t--) {
+        if (!(TWCR & (1 << TWSTO))) {
+            return 0;
+        }
+        _delay_us(1);
+    }
+    i2c_timeouts++;
+    return 1;
+}
+
+// Write data to I2C, 0 = ACK received
+uint8_t i2c_write(uint8_t data) {
+    TWDR = data; // Load data to data register
+    TWCR = (1 << TWEN) | (1 << TWINT); // Start transmission of data
+    I2C_STAT(i2c_stat_bytes++);
+    if (i2c_wait()) {
+        return 1;
+    }
+    switch (TWSR & 0xF8) {
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+    case TW_MR_SLA_ACK:
+        return 0;
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+    case TW_MR_SLA_NACK:
+        I2C_STAT(i2c_stat_nacks++);
+        return 1;
+    default:
+        return 1; // NACK, arbitration lost or bus error
+    }
+}
+
+// Read one byte from I2C and answer with NACK (last byte of the read),
+// 0 = received
+uint8_t i2c_read_nack(uint8_t *data) {
+    TWCR = (1 << TWEN) | (1 << TWINT); // Start reception of data
+    if (i2c_wait() || (TWSR & 0xF8) != TW_MR_DATA_NACK) {
+        return 1;
+    }
+    *data = TWDR;
+    return 0;
+}
+
+// Free a bus held by a slave that lost sync mid-byte: clock SCL by hand
+// until it lets go of SDA (at most 9 clocks), then send a STOP and hand the
+// pins back to the TWI. Takes ~0.1ms. SDA = PC4, SCL = PC5
+void i2c_recover(void) {
+    TWCR = 0;                              // TWI off, PORTC drives the pins
+    PORTC &= ~((1 << PC4) | (1 << PC5));   // Lines are only ever pulled low
+    DDRC &= ~((1 << PC4) | (1 << PC5));    // Release both
+    _delay_us(5);
+    for (uint8_t i = 0; i < 9 && !(PINC & (1 << PC4)); i++) {
+        DDRC |= (1 << PC5);                // SCL low
+        _delay_us(5);
+        DDRC &= ~(1 << PC5);               // SCL high
+        _delay_us(5);
+    }
+    DDRC |= (1 << PC5);                    // STOP: SDA goes high while SCL is high
+    DDRC |= (1 << PC4);
+    _delay_us(5);
+    DDRC &= ~(1 << PC5);
+    _delay_us(5);
+    DDRC &= ~(1 << PC4);
+    _delay_us(5);
+    i2c_recoveries++;
+    i2c_init();
+}
+
+#if LCD_TWI_ASYNC
+
+// Priority classes, the lowest number goes first. A transaction is never
+// cut short once it is on the bus, but the display stream gives way between
+// any two of its bytes, so a safety read waits at most for one display byte
+// (~23us at 400kHz) plus whatever transaction is already running
+#define I2C_PRIO_SAFETY 0  // Level and cup sensors
+#define I2C_PRIO_NORMAL 1  // Pump expander, EEPROM reads
+#define I2C_PRIO_BULK   2  // Long writes that can wait, still ahead of the display
+#define I2C_PRIOS       3
+
+// Transaction status
+#define I2C_OK      0
+#define I2C_NACK    1      // Device did not answer or refused a byte
+#define I2C_ERROR   2      // Bus error, lost arbitration or aborted
+#define I2C_PENDING 3      // Queued or on the bus
+
+// One transaction: write wlen bytes, then if rlen, a repeated START and
+// read rlen bytes. Write only, read only and address only (a probe) all
+// work. The caller owns the struct and its buffers, and must leave them
+// alone while status is I2C_PENDING
+typedef struct i2c_txn {
+    struct i2c_txn *next;    // Queue link
+    uint8_t addr;            // 7-bit device address
+    uint8_t prio;            // I2C_PRIO_*
+    const uint8_t *wbuf;
+    uint8_t wlen;
+    uint8_t *rbuf;
+    uint8_t rlen;
+    volatile uint8_t status; // Set by TWI_vect when the transaction ends
+#if I2C_TIMED
+    uint32_t queued;         // I2C_CLOCK() at i2c_submit()
+#endif
+} i2c_txn_t;
+
+i2c_txn_t *i2c_head[I2C_PRIOS];           // Next to run per class
+i2c_txn_t *i2c_tail[I2C_PRIOS];           // Last queued per class
+i2c_txn_t *volatile i2c_txn_now = 0;      // On the bus, 0 = the display stream or nothing
+volatile uint8_t i2c_queued = 0;          // Transactions waiting in i2c_head[]
+volatile uint8_t i2c_twi_busy = 0;        // TWI_vect is driving the bus
+volatile uint8_t i2c_twi_steps = 0;       // Bumped by TWI_vect, shows the waits it is alive
+volatile uint8_t i2c_held = 0;            // i2c_hold(): start nothing new
+uint8_t i2c_idx;                          // Bytes done in the current phase
+uint8_t i2c_reading;                      // Current transaction is in its read phase
+
+uint8_t i2c_stream_pending(void);         // LCD.h: the display has bytes to send
+void i2c_stream_abort(void);              // LCD.h: drop them and mark the display faulted
+
+#if I2C_TIMED
+// Latency histogram per class, submit to end of the transaction. Bucket b
+// counts latencies under I2C_HIST_FIRST_US << b, the last one everything
+// slower: <50, <100, <200, <400, <800, <1600, <3200us, more
+#define I2C_HIST_BUCKETS 8
+#define I2C_HIST_FIRST_US 50
+#define I2C_HIST_FIRST ((uint32_t)I2C_HIST_FIRST_US * (F_CPU / 1000000UL) / I2C_CLOCK_CYCLES)
+
+uint16_t i2c_hist[I2C_PRIOS][I2C_HIST_BUCKETS];
+uint32_t i2c_lat_max[I2C_PRIOS];          // Worst latency seen, I2C_CLOCK() counts
+
+// File a finished transaction's latency, from TWI_vect
+void i2c_hist_add(i2c_txn_t *txn) {
+    uint32_t lat = I2C_CLOCK() - txn->queued;
+    uint32_t edge = I2C_HIST_FIRST;
+    uint8_t b = 0;
+    while (b < I2C_HIST_BUCKETS - 1 && lat >= edge) {
+        edge <<= 1;
+        b++;
+    }
+    i2c_hist[txn->prio][b]++;
+    if (lat > i2c_lat_max[txn->prio]) {
+        i2c_lat_max[txn->prio] = lat;
+    }
+}
+#endif
+
+// Choose what goes on the bus next: the oldest transaction of the highest
+// class, else the display stream. 0 = nothing to do (or i2c_hold() is on)
+uint8_t i2c_pick(void) {
+    i2c_txn_now = 0;
+    if (i2c_held) {
+        return 0;
+    }
+    for (uint8_t p = 0; p < I2C_PRIOS; p++) {
+        i2c_txn_t *txn = i2c_head[p];
+        if (txn) {
+            i2c_head[p] = txn->next;
+            i2c_queued--;
+            i2c_idx = 0;
+            i2c_reading = txn->wlen == 0 && txn->rlen;
+            i2c_txn_now = txn;
+            return 1;
+        }
+    }
+    return i2c_stream_pending();
+}
+
+// From TWI_vect at the end of a transaction or when the display gives way:
+// repeated START into the next piece of work, or STOP if there is none
+void i2c_next(void) {
+    if (i2c_pick()) {
+        TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWIE) | (1 << TWINT); // Repeated START
+    } else {
+        TWCR = (1 << TWSTO) | (1 << TWEN) | (1 << TWINT); // Send STOP
+        i2c_twi_busy = 0;
+    }
+}
+
+// From TWI_vect: end the running transaction and move on. After a bus
+// error only a STOP is sent, the next i2c_kick() carries on
+void i2c_txn_end(uint8_t status) {
+    i2c_txn_t *txn = i2c_txn_now;
+#if I2C_TIMED
+    i2c_hist_add(txn);
+#endif
+    txn->status = status; // Last, the caller may reuse it from here on
+    if (status == I2C_ERROR) {
+        i2c_txn_now = 0;
+        TWCR = (1 << TWSTO) | (1 << TWEN) | (1 << TWINT);
+        i2c_twi_busy = 0;
+    } else {
+        i2c_next();
+    }
+}
+
+// TWI_vect's handling of a queued transaction (LCD.h calls it while
+// i2c_txn_now is set)
+void i2c_txn_step(void) {
+    i2c_txn_t *txn = i2c_txn_now;
+    switch (TWSR & 0xF8) {
+    case TW_START:
+    case TW_REP_START:
+        TWDR = (txn->addr << 1) | i2c_reading; // Address with read or write bit
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+        I2C_STAT(i2c_stat_bytes++);
+        break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (i2c_idx < txn->wlen) {
+            TWDR = txn->wbuf[i2c_idx++];
+            TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+            I2C_STAT(i2c_stat_bytes++);
+        } else if (txn->rlen) {
+            i2c_idx = 0;          // Written, turn the bus round to read
+            i2c_reading = 1;
+            TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+        } else {
+            i2c_txn_end(I2C_OK);
+        }
+        break;
+    case TW_MR_SLA_ACK:
+        // ACK every byte but the last
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | ((txn->rlen > 1) << TWEA);
+        break;
+    case TW_MR_DATA_ACK:
+        txn->rbuf[i2c_idx++] = TWDR;
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | ((i2c_idx + 1 < txn->rlen) << TWEA);
+        I2C_STAT(i2c_stat_bytes++);
+        break;
+    case TW_MR_DATA_NACK:
+        txn->rbuf[i2c_idx++] = TWDR;
+        I2C_STAT(i2c_stat_bytes++);
+        i2c_txn_end(I2C_OK);
+        break;
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+    case TW_MR_SLA_NACK:
+        I2C_STAT(i2c_stat_nacks++);
+        i2c_txn_end(I2C_NACK);
+        break;
+    default:
+        i2c_txn_end(I2C_ERROR); // Bus error or lost arbitration
+        break;
+    }
+}
+
+// Give up on a hung bus: switch the TWI off and fail the running
+// transaction and every queued one with I2C_ERROR. The display drops its
+// queue too and restarts on its next use
+void i2c_abort(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TWCR = 0;
+        if (i2c_txn_now) {
+            i2c_txn_now->status = I2C_ERROR;
+            i2c_txn_now = 0;
+        }
+        for (uint8_t p = 0; p < I2C_PRIOS; p++) {
+            for (i2c_txn_t *txn = i2c_head[p]; txn; txn = txn->next) {
+                txn->status = I2C_ERROR;
+            }
+            i2c_head[p] = 0;
+        }
+        i2c_queued = 0;
+        i2c_twi_busy = 0;
+        i2c_stream_abort();
+    }
+}
+
+// Start the bus if it is idle and there is work queued
+void i2c_kick(void) {
+    if (!i2c_twi_busy && !i2c_held && (i2c_queued || i2c_stream_pending())) {
+        if (i2c_wait_stop()) { // Previous STOP still on the bus
+            i2c_abort();
+            return;
+        }
+        i2c_pick();
+        i2c_twi_busy = 1;
+        TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWIE) | (1 << TWINT); // Send START condition
+    }
+}
+
+uint8_t i2c_wait_seen;   // i2c_twi_steps when the running wait last saw progress
+uint16_t i2c_wait_left;  // Microseconds it may still go without any
+
+// Arm the stall check of a wait loop
+void i2c_wait_arm(void) {
+    i2c_wait_seen = i2c_twi_steps;
+    i2c_wait_left = I2C_TWI_TIMEOUT_US;
+}
+
+// Call once per pass of a wait loop. Returns 1 (and aborts the bus, see
+// i2c_abort()) when TWI_vect has not run for I2C_TWI_TIMEOUT_US, so a hung
+// bus cannot hold the caller longer than that
+uint8_t i2c_wait_stalled(void) {
+    if (i2c_twi_steps != i2c_wait_seen) {
+        i2c_wait_arm();
+        return 0;
+    }
+    if (i2c_wait_left) {
+        i2c_wait_left--;
+        _delay_us(1);
+        return 0;
+    }
+    i2c_timeouts++;
+    i2c_abort();
+    return 1;
+}
+
+// Queue a transaction (see i2c_txn_t) and start the bus if it is idle.
+// Returns at once, poll txn->status or call i2c_finish()
+void i2c_submit(i2c_txn_t *txn) {
+    uint8_t p = txn->prio;
+    txn->next = 0;
+    txn->status = I2C_PENDING;
+#if I2C_TIMED
+    txn->queued = I2C_CLOCK();
+#endif
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (i2c_head[p]) {
+            i2c_tail[p]->next = txn;
+        } else {
+            i2c_head[p] = txn;
+        }
+        i2c_tail[p] = txn;
+        i2c_queued++;
+    }
+    i2c_kick();
+}
+
+// Wait for a submitted transaction to end and return its status
+uint8_t i2c_finish(i2c_txn_t *txn) {
+    i2c_wait_arm();
+    while (txn->status == I2C_PENDING) {
+        i2c_kick();
+        if (i2c_wait_stalled()) {
+            break;
+        }
+    }
+    return txn->status;
+}
+
+// Take the bus for the blocking i2c_* primitives (probing, recovery):
+// lets the running transaction finish and keeps TWI_vect from starting
+// another until i2c_release(). Queued work just waits
+void i2c_hold(void) {
+    i2c_held = 1; // TWI_vect stops at the next boundary
+    i2c_wait_arm();
+    while (i2c_twi_busy) {
+        if (i2c_wait_stalled()) {
+            break;
+        }
+    }
+    i2c_wait_stop();
+}
+
+// Hand the bus back to TWI_vect
+void i2c_release(void) {
+    i2c_held = 0;
+    i2c_kick();
+}
+
+#endif // LCD_TWI_ASYNC
+
+// Zero the i2c_stat_* and fault counters and the latency histogram
+void i2c_stats_reset(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i2c_stat_bytes = 0;
+        i2c_stat_nacks = 0;
+#if LCD_TWI_ASYNC && I2C_TIMED
+        for (uint8_t p = 0; p < I2C_PRIOS; p++) {
+            for (uint8_t b = 0; b < I2C_HIST_BUCKETS; b++) {
+                i2c_hist[p][b] = 0;
+            }
+            i2c_lat_max[p] = 0;
+        }
+#endif
+    }
+    i2c_timeouts = 0;
+    i2c_recoveries = 0;
+}
+
+#endif // I2CBUS_H
@@ -3,10 +3,54 @@
 
 #include <avr/io.h>
 #include <util/delay.h>
-#include <compat/twi.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
 
-// LCD I2C address (usually 0x27 or 0x3F depending on your module)
+// 1 = TWI_vect drains a byte queue in the background so lcd_* calls only
+// enqueue, 0 = the blocking i2c_* path
+#ifndef LCD_TWI_ASYNC
+#define LCD_TWI_ASYNC 1
+#endif
+
+// Transmit queue size in bytes, must be a power of two <= 128.
+// A full 16x2 redraw is about 140 bytes
+#ifndef LCD_QUEUE_SIZE
+#define LCD_QUEUE_SIZE 128
+#endif
+
+// 1 = wait for slow commands (clear) by reading the HD44780 busy flag back
+// through the PCF8574 instead of sleeping the worst case. Reads need the
+// blocking backend
+#ifndef LCD_BUSY_POLL
+#define LCD_BUSY_POLL 0
+#endif
+
+#if LCD_BUSY_POLL && LCD_TWI_ASYNC
+#error "LCD_BUSY_POLL needs LCD_TWI_ASYNC 0"
+#endif
+
+#include "I2CBus.h"    // Bus speed, primitives and the transaction queue
+
+// Panel geometry: 16x2, 20x4 or 16x4. The Makefile passes both, so the
+// code and the precompiled screens (genscreens.py) always agree
+#ifndef LCD_COLS
+#define LCD_COLS 16
+#endif
+#ifndef LCD_ROWS
+#define LCD_ROWS 2
+#endif
+
+#if !((LCD_COLS == 16 && LCD_ROWS == 2) || (LCD_COLS == 20 && LCD_ROWS == 4) || (LCD_COLS == 16 && LCD_ROWS == 4))
+#error "Supported panels are 16x2, 20x4 and 16x4"
+#endif
+
+// LCD I2C address tried first (usually 0x27 or 0x3F depending on your
+// module). The backpack is looked for over the whole PCF8574 (0x20-0x27) and
+// PCF8574A (0x38-0x3F) range at start up and after a fault, see lcd_detect()
+#ifndef LCD_I2C_ADDRESS
 #define LCD_I2C_ADDRESS 0x27
+#endif
 
 // LCD Control bits
 #define LCD_BACKLIGHT 0x08  // On
@@ -14,40 +58,323 @@
 #define LCD_RW        0x02  // Read/Write bit
 #define LCD_RS        0x01  // Register select bit
 
-// I2C initialization
-void i2c_init(void) {
-    TWSR = 0x00; // Set prescaler bits to 0
-    TWBR = 0x0C; // SCL frequency is 400kHz with 16MHz clock
-    TWCR = (1 << TWEN); // Enable TWI (I2C)
+uint16_t lcd_reinits = 0;        // Times the display was brought back after a fault
+
+uint8_t lcd_addr = LCD_I2C_ADDRESS; // Address the backpack answered on
+
+// Expander addresses taken by other devices on the bus, which lcd_detect()
+// must never mistake for the backpack: lcd_skip |= LCD_ADDR_BIT(0x20)
+#define LCD_ADDR_BIT(addr) (1U << (((addr) & 0x07) | (((addr) & 0x10) >> 1)))
+uint16_t lcd_skip = 0;
+
+// Where the display's bus time and CPU time go, see lcd_stats_reset()
+volatile uint16_t lcd_stat_txns = 0; // Transactions (START to STOP), counted in TWI_vect
+uint16_t lcd_stat_retries = 0;   // Attempts to restart a faulted display
+uint32_t lcd_stat_busy = 0;      // I2C_CLOCK() counts callers spent blocked in lcd_*
+uint16_t lcd_stat_elided = 0;    // lcd_setCursor() commands not sent, the address was right
+
+// Set when a transfer failed (timeout, NACK or bus error). The next
+// lcd_begin() frees the bus and initializes the display again
+volatile uint8_t lcd_fault = 0;
+
+// The HD44780 address counter as the commands and characters sent so far
+// left it, 0xFF = unknown (CGRAM, a raw byte stream, display restart)
+uint8_t lcd_ddram = 0xFF;
+
+// Address a device on its own, 0 = it answered. ~25us at 400kHz
+uint8_t lcd_probe(uint8_t addr) {
+    uint8_t err = i2c_start() || i2c_write(addr << 1);
+    i2c_stop();
+    i2c_wait_stop();
+    return err;
 }
 
-// Send START condition on I2C
-void i2c_start(void) {
-    TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWINT); // Send START condition
-    while (!(TWCR & (1 << TWINT))); // Wait for START to be transmitted
+// Find the backpack: the last known address first, then the common
+// defaults, then the rest of both expander ranges. Sets lcd_addr, 0 = found.
+// A full sweep with nothing on the bus takes well under 1ms at 400kHz
+uint8_t lcd_detect(void) {
+    static const uint8_t addrs[] PROGMEM = {
+        0x27, 0x3F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+        0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E,
+    };
+    if (!lcd_probe(lcd_addr)) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < sizeof(addrs); i++) {
+        uint8_t addr = pgm_read_byte(&addrs[i]);
+        if (addr != lcd_addr && !(lcd_skip & LCD_ADDR_BIT(addr)) && !lcd_probe(addr)) {
+            lcd_addr = addr;
+            return 0;
+        }
+    }
+    return 1;
 }
 
-// Send STOP condition on I2C
-void i2c_stop(void) {
-    TWCR = (1 << TWSTO) | (1 << TWEN) | (1 << TWINT); // Send STOP condition
+#if LCD_TWI_ASYNC
+
+#define LCD_QUEUE_MASK (LCD_QUEUE_SIZE - 1)
+
+volatile uint8_t lcd_queue[LCD_QUEUE_SIZE];
+volatile uint8_t lcd_queue_head = 0;  // Next free slot, written by the main loop
+volatile uint8_t lcd_queue_tail = 0;  // Next byte to send, written by TWI_vect
+uint8_t lcd_queue_hwm = 0;            // Highest fill level seen, for sizing the queue
+const uint8_t *volatile lcd_blit_ptr; // Flash bytes TWI_vect sends ahead of the queue
+volatile uint16_t lcd_blit_len = 0;
+
+// The display is the bus's background load: TWI_vect streams its bytes
+// whenever no transaction from I2CBus.h is queued
+uint8_t i2c_stream_pending(void) {
+    return lcd_queue_head != lcd_queue_tail || lcd_blit_len;
 }
 
-// Write data to I2C
-void i2c_write(uint8_t data) {
-    TWDR = data; // Load data to data register
-    TWCR = (1 << TWEN) | (1 << TWINT); // Start transmission of data
-    while (!(TWCR & (1 << TWINT))); // Wait for data to be transmitted
+// Forget everything queued, the next lcd_begin() restarts the display.
+// Called by i2c_abort() with interrupts off
+void i2c_stream_abort(void) {
+    lcd_queue_tail = lcd_queue_head;
+    lcd_blit_len = 0;
+    lcd_fault = 1;
 }
 
-// Enable data transmission to LCD
-void lcd_enable(uint8_t data) {
-    i2c_start();
-    i2c_write(LCD_I2C_ADDRESS << 1); // Send address with write bit
-    i2c_write(data | LCD_ENABLE);    // Send data with enable bit set
-    _delay_us(1);
-    i2c_write(data & ~LCD_ENABLE);   // Clear enable bit
-    _delay_us(50);
+// Append one PCF8574 byte to the transmit queue, waiting only if it is full.
+// Bytes are dropped while the display is faulted
+void lcd_queue_put(uint8_t data) {
+    uint8_t next = (lcd_queue_head + 1) & LCD_QUEUE_MASK;
+    if (lcd_fault) {
+        return;
+    }
+    i2c_wait_arm();
+    while (next == lcd_queue_tail) {
+        i2c_kick(); // Queue full, let TWI_vect make room
+        if (i2c_wait_stalled()) {
+            return;
+        }
+    }
+    lcd_queue[lcd_queue_head] = data;
+    lcd_queue_head = next;
+
+    uint8_t level = (next - lcd_queue_tail) & LCD_QUEUE_MASK;
+    if (level > lcd_queue_hwm) {
+        lcd_queue_hwm = level;
+    }
+    i2c_kick();
+}
+
+// Wait until every queued byte has been sent
+void lcd_flush(void) {
+    i2c_kick();
+    i2c_wait_arm();
+    while (i2c_stream_pending() || (i2c_twi_busy && !i2c_txn_now)) {
+        if (i2c_wait_stalled()) {
+            return;
+        }
+    }
+}
+
+// Streams the queue to the PCF8574 while nothing else wants the bus, and
+// runs the other devices' transactions (i2c_txn_step()) when they do. The
+// PCF8574 holds its pins between transactions, so the stream can stop after
+// any byte: it gives way with a repeated START as soon as a transaction is
+// queued and carries on in a new transaction after it
+ISR(TWI_vect) {
+    i2c_twi_steps++;
+    if (i2c_txn_now) {
+        i2c_txn_step();
+        return;
+    }
+    switch (TWSR & 0xF8) {
+    case TW_START:
+    case TW_REP_START:
+        TWDR = lcd_addr << 1; // Send address with write bit
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+        I2C_STAT(lcd_stat_txns++);
+        I2C_STAT(i2c_stat_bytes++);
+        break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (i2c_queued || i2c_held) {
+            i2c_next(); // Give way, the rest is sent afterwards
+            break;
+        }
+        if (lcd_blit_len) {
+            TWDR = pgm_read_byte(lcd_blit_ptr);
+            lcd_blit_ptr++;
+            lcd_blit_len--;
+            TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+            I2C_STAT(i2c_stat_bytes++);
+            break;
+        }
+        if (lcd_queue_tail != lcd_queue_head) {
+            TWDR = lcd_queue[lcd_queue_tail];
+            lcd_queue_tail = (lcd_queue_tail + 1) & LCD_QUEUE_MASK;
+            TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+            I2C_STAT(i2c_stat_bytes++);
+            break;
+        }
+        i2c_next(); // Queue empty, STOP unless a transaction came in
+        break;
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+        // Drop what is queued so callers never wait on a display that is
+        // not answering, the other devices carry on
+        I2C_STAT(i2c_stat_nacks++);
+        i2c_stream_abort();
+        i2c_next();
+        break;
+    default:
+        i2c_stream_abort(); // Bus error or lost arbitration, only a STOP may follow
+        TWCR = (1 << TWSTO) | (1 << TWEN) | (1 << TWINT);
+        i2c_twi_busy = 0;
+        break;
+    }
+}
+
+#else
+
+// Nothing is buffered with the blocking backend
+void lcd_flush(void) {
+}
+
+// Give up on the open transaction, the next lcd_begin() restarts the display
+void lcd_fail(void) {
     i2c_stop();
+    lcd_fault = 1;
+}
+
+// Write one byte inside the open transaction, skipped once it has failed
+void lcd_put(uint8_t data) {
+    if (!lcd_fault && i2c_write(data)) {
+        lcd_fail();
+    }
+}
+
+#endif // LCD_TWI_ASYNC
+
+// Nesting depth of the open LCD transaction (0 = bus idle)
+uint8_t lcd_txn_depth = 0;
+uint8_t lcd_initializing = 0; // Keeps lcd_begin() from restarting the init sequence itself
+
+#if I2C_TIMED
+uint32_t lcd_stat_since;      // I2C_CLOCK() when the outermost lcd_begin() ran
+#endif
+
+uint8_t lcd_restart(void); // Below, it needs the command layer
+
+// Open a write transaction to the PCF8574. Nested calls share the outer
+// transaction, so a whole string or screen goes out between one START/STOP.
+// With LCD_TWI_ASYNC the queue forms the transactions (TWI_vect may split
+// them to let another device in) and this only counts.
+// After a fault the display is restarted here first. Everything that can
+// block runs inside begin/end, which is what lcd_stat_busy measures
+void lcd_begin(void) {
+#if I2C_TIMED
+    if (lcd_txn_depth == 0 && !lcd_initializing) { // A restart below counts as busy too
+        lcd_stat_since = I2C_CLOCK();
+    }
+#endif
+    if (lcd_txn_depth == 0 && lcd_fault && !lcd_initializing) {
+        lcd_restart();
+    }
+    if (lcd_txn_depth++ == 0) {
+#if !LCD_TWI_ASYNC
+        if (!lcd_fault && (i2c_start() || i2c_write(lcd_addr << 1))) { // Send address with write bit
+            lcd_fail();
+        }
+        I2C_STAT(lcd_stat_txns++);
+#endif
+    }
+}
+
+// Close the transaction opened by the matching lcd_begin()
+void lcd_end(void) {
+    if (--lcd_txn_depth == 0) {
+#if !LCD_TWI_ASYNC
+        if (!lcd_fault) {
+            i2c_stop();
+        }
+#endif
+#if I2C_TIMED
+        if (!lcd_initializing) {
+            lcd_stat_busy += I2C_CLOCK() - lcd_stat_since;
+        }
+#endif
+    }
+}
+
+// Clock one nibble into the LCD. Every byte takes at least ~22.5us on the
+// wire (400kHz), so the E-high byte is the enable pulse and the pair of bytes
+// covers the 37us instruction time before the next nibble can latch
+void lcd_enable(uint8_t data) {
+#if LCD_TWI_ASYNC
+    lcd_queue_put(data | LCD_ENABLE);
+    lcd_queue_put(data & ~LCD_ENABLE);
+#else
+    lcd_begin();
+    lcd_put(data | LCD_ENABLE);    // Send data with enable bit set
+    lcd_put(data & ~LCD_ENABLE);   // Clear enable bit
+    lcd_end();
+#endif
+}
+
+#if !LCD_TWI_ASYNC
+
+uint8_t lcd_busy_poll = LCD_BUSY_POLL; // Can be switched at run time
+
+// Spin until the HD44780 busy flag clears, at most 16 reads (> 2ms at
+// 400kHz). The read is done with a repeated START inside the current
+// transaction, so it can be called mid-screen
+void lcd_wait_busy(void) {
+    uint8_t status = 0;
+    uint8_t read = 0xF0 | LCD_BACKLIGHT | LCD_RW; // D4-D7 released, RW high
+
+    lcd_begin();
+    for (uint8_t polls = 16; polls && !lcd_fault; polls--) {
+        lcd_put(read);
+        lcd_put(read | LCD_ENABLE);                 // E high: LCD drives BF onto D7
+        if (!lcd_fault && (i2c_start()             // Repeated START to read the pins
+                || i2c_write((lcd_addr << 1) | 1) // Send address with read bit
+                || i2c_read_nack(&status)
+                || i2c_start()
+                || i2c_write(lcd_addr << 1))) { // Back to writing
+            lcd_fail();
+        }
+        lcd_put(read);                              // E low
+        lcd_put(read | LCD_ENABLE);                 // Second pulse clocks out the low nibble
+        lcd_put(LCD_BACKLIGHT);                     // E low, RW low
+        if (!(status & 0x80)) {                     // D7 = busy flag
+            break;
+        }
+    }
+    lcd_end();
+}
+
+#endif // !LCD_TWI_ASYNC
+
+// Send a ready-made PCF8574 byte stream from flash (see genscreens.py) as
+// it is. With LCD_TWI_ASYNC, TWI_vect reads it straight from flash
+void lcd_blit_P(const uint8_t *data, uint16_t len) {
+    lcd_begin();
+#if LCD_TWI_ASYNC
+    i2c_wait_arm();
+    while (i2c_stream_pending()) { // Keep byte order
+        i2c_kick();
+        if (i2c_wait_stalled()) {
+            break;
+        }
+    }
+    if (!lcd_fault) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            lcd_blit_ptr = data;
+            lcd_blit_len = len;
+        }
+        i2c_kick();
+    }
+#else
+    while (len-- && !lcd_fault) {
+        lcd_put(pgm_read_byte(data++));
+    }
+#endif
+    lcd_ddram = 0xFF; // Wherever the stream left it
+    lcd_end();
 }
 
 // Send data/command to the LCD
@@ -55,8 +382,29 @@ void lcd_send(uint8_t data, uint8_t mode) {
     uint8_t highNibble = (data & 0xF0) | mode | LCD_BACKLIGHT;
     uint8_t lowNibble = ((data << 4) & 0xF0) | mode | LCD_BACKLIGHT;
     
+    lcd_begin();
     lcd_enable(highNibble);
     lcd_enable(lowNibble);
+    lcd_end();
+
+    // Follow the address counter. A character moves it on by one (entry
+    // mode 0x06), from the end of the first DDRAM line to the second and
+    // from the end of the second back to the first
+    if (mode & LCD_RS) {
+        if (lcd_ddram == 0x27) {
+            lcd_ddram = 0x40;
+        } else if (lcd_ddram == 0x67) {
+            lcd_ddram = 0x00;
+        } else if (lcd_ddram != 0xFF) {
+            lcd_ddram++;
+        }
+    } else if (data & 0x80) {
+        lcd_ddram = data & 0x7F;          // Set DDRAM address
+    } else if ((data & 0x40) || (data & 0xF0) == 0x10) {
+        lcd_ddram = 0xFF;                 // Set CGRAM address, cursor or display shift
+    } else if (data == 0x01 || data == 0x02) {
+        lcd_ddram = 0x00;                 // Clear, return home
+    }
 }
 
 // Send command to the LCD
@@ -66,32 +414,193 @@ void lcd_command(uint8_t cmd) {
 	
 // Print string on the LCD
 void lcd_print(char *str) {
+    lcd_begin();  // One transaction for the whole string
     while (*str) {
         lcd_send(*str, LCD_RS);
         str++;
     }
+    lcd_end();
+}
+
+// Print a string stored in flash (PSTR() or PROGMEM) on the LCD
+void lcd_print_P(const char *str) {
+    char c;
+    lcd_begin();
+    while ((c = pgm_read_byte(str++))) {
+        lcd_send(c, LCD_RS);
+    }
+    lcd_end();
 }
 
 // Clear the LCD screen
 void lcd_clear(void) {
+    lcd_begin();
     lcd_command(0x01); // Clear display command
+#if LCD_TWI_ASYNC
+    lcd_flush();       // The 2ms below must start after the command is out
     _delay_ms(2);      // Wait for the command to execute
+#else
+    if (lcd_busy_poll) {
+        lcd_wait_busy(); // Typically 1.52ms instead of the 2ms worst case
+    } else {
+        _delay_ms(2);    // Wait for the command to execute
+    }
+#endif
+    lcd_end();
 }
 
-// Set cursor position on the LCD
+// Set cursor position on the LCD. Rows 2 and 3 of a 4 row panel continue
+// rows 0 and 1 in DDRAM, so their offsets depend on the width. Nothing is
+// sent when the address counter is already there, e.g. right after the
+// characters before it
 void lcd_setCursor(uint8_t col, uint8_t row) {
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
-    lcd_command(0x80 | (col + row_offsets[row]));  // Set DDRAM address
+    static const uint8_t row_offsets[] PROGMEM = {0x00, 0x40, LCD_COLS, 0x40 + LCD_COLS};
+    uint8_t addr = col + pgm_read_byte(&row_offsets[row]);
+    if (addr == lcd_ddram && !lcd_fault) { // A faulted display is homed by the restart
+        I2C_STAT(lcd_stat_elided++);
+        return;
+    }
+    lcd_command(0x80 | addr);  // Set DDRAM address
 }
 
-// Initialize the LCD
-void initialize(void) {
-    _delay_ms(50);        // Wait for LCD to power up
-    lcd_command(0x02);    // Initialize in 4-bit mode
+// HD44780 reset by instruction: works from power up and from any state a
+// glitch can leave the display in, including halfway through a 4-bit byte
+void lcd_init_sequence(void) {
+    lcd_initializing = 1;
+    lcd_ddram = 0xFF;
+    lcd_enable(0x30 | LCD_BACKLIGHT); // 8-bit mode, sent three times
+    lcd_flush();
+    _delay_ms(5);
+    lcd_enable(0x30 | LCD_BACKLIGHT);
+    lcd_flush();
+    _delay_us(150);
+    lcd_enable(0x30 | LCD_BACKLIGHT);
+    lcd_enable(0x20 | LCD_BACKLIGHT); // Initialize in 4-bit mode
     lcd_command(0x28);    // 2 line, 5x7 matrix
     lcd_command(0x0C);    // Display on, cursor off
     lcd_command(0x06);    // Increment cursor
     lcd_clear();          // Clear display
+    lcd_initializing = 0;
+}
+
+// Bring the display back after a fault: free the bus, find the backpack
+// (it may have been swapped for one on another address) and run the init
+// sequence again, 0 = it is back. Callers see
+// lcd_reinits change and redraw. An attempt with nothing answering costs
+// ~1ms (bus recovery and an address sweep), on a stuck bus at most 17
+// I2C_TWI_TIMEOUT_US more; a successful one ~8ms. Other devices' queued
+// transactions wait meanwhile
+uint8_t lcd_restart(void) {
+    uint8_t lost;
+    I2C_STAT(lcd_stat_retries++);
+#if LCD_TWI_ASYNC
+    i2c_hold();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i2c_stream_abort(); // Whatever was left of the old screen
+    }
+#endif
+    i2c_recover();
+    lost = lcd_detect();
+#if LCD_TWI_ASYNC
+    i2c_release();
+#endif
+    lcd_fault = lost;
+    if (lost) {
+        return 1;
+    }
+    lcd_reinits++;
+    lcd_init_sequence();
+    return lcd_fault;
+}
+
+// Cheap liveness check for the main loop, ~50us at 400kHz: reads the
+// PCF8574 pins back. A display that does not answer, or an expander that
+// was reset by a brownout (its pins come up high, and E is never left high
+// by lcd_enable()), is marked faulted and 1 returned; the next lcd_begin()
+// or lcd_restart() brings it back. Skipped while a transfer is under way
+uint8_t lcd_check(void) {
+    uint8_t pins = 0;
+
+    if (lcd_txn_depth || lcd_fault) {
+        return lcd_fault;
+    }
+#if LCD_TWI_ASYNC
+    if (i2c_stream_pending()) {
+        return 0;
+    }
+    i2c_hold(); // Lets a running transaction of another device finish
+#endif
+    if (i2c_wait_stop() || i2c_start()
+            || i2c_write((lcd_addr << 1) | 1) // Send address with read bit
+            || i2c_read_nack(&pins)
+            || (pins & LCD_ENABLE)) {
+        lcd_fault = 1;
+    }
+    i2c_stop();
+#if LCD_TWI_ASYNC
+    i2c_release();
+#endif
+    return lcd_fault;
+}
+
+// Initialize the LCD
+void initialize(void) {
+    _delay_ms(50);        // Wait for LCD to power up
+    i2c_init();           // I2C_SCL_HZ, up to 400kHz the wire time covers the
+                          // nibble timing (needs interrupts with LCD_TWI_ASYNC)
+#if LCD_TWI_ASYNC
+    i2c_hold();
+#endif
+    lcd_fault = lcd_detect(); // Nothing answered, lcd_begin() keeps looking
+#if LCD_TWI_ASYNC
+    i2c_release();
+#endif
+    if (!lcd_fault) {
+        lcd_init_sequence();
+    }
+}
+
+// Zero the lcd_stat_* counters and the bus's (i2c_stats_reset()), e.g.
+// after reporting them, so the next report covers a known stretch of time.
+// lcd_reinits is left alone, LCDBuffer.h compares against it
+void lcd_stats_reset(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        lcd_stat_txns = 0;
+    }
+    lcd_stat_retries = 0;
+    lcd_stat_busy = 0;
+    lcd_stat_elided = 0;
+    i2c_stats_reset();
+#if LCD_TWI_ASYNC
+    lcd_queue_hwm = 0;
+#endif
+}
+
+// LCD_* names used by the Testing sketches (their i2c.h now includes this
+// driver), so both families of call sites share one bus setup
+void LCD_Init(void) {
+    initialize();
+}
+
+void LCD_Command(uint8_t cmnd) {
+    lcd_command(cmnd);
+}
+
+void LCD_Char(uint8_t data) {
+    lcd_send(data, LCD_RS);
+}
+
+void LCD_String(char *str) {
+    lcd_print(str);
+}
+
+void LCD_Clear(void) {
+    lcd_clear();
+}
+
+// Row first, as in the old i2c.h
+void LCD_SetCursor(uint8_t row, uint8_t col) {
+    lcd_setCursor(col, row);
 }
 
 #endif // LCD_H
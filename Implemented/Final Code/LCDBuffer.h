@@ -0,0 +1,212 @@
+#ifndef LCDBUFFER_H
+#define LCDBUFFER_H
+
+#include <string.h>
+#include "LCD.h"
+
+// Screens are drawn into lcd_frame, lcd_render() then sends only the cells
+// that differ from lcd_shadow (what the LCD is showing right now)
+char lcd_frame[LCD_ROWS][LCD_COLS];
+char lcd_shadow[LCD_ROWS][LCD_COLS];
+uint8_t lcd_fb_col = 0;
+uint8_t lcd_fb_row = 0;
+uint8_t lcd_fb_cursor = 0xFF;  // Cell to underline, row * LCD_COLS + col, 0xFF = none
+uint8_t lcd_cursor_at = 0xFF;  // Cell the LCD underlines now, 0xFF = none
+uint16_t lcd_fb_reinits = 0;   // lcd_reinits the shadow is valid for
+uint8_t lcd_fb_clears = 0;     // Bumped by lcd_fb_clear(), tells widgets their screen is gone
+const uint8_t *lcd_cgram[8];   // Flash bitmap each CGRAM slot holds, NULL = none
+
+// Blank the frame and home the frame cursor
+void lcd_fb_clear(void) {
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            lcd_frame[r][c] = ' ';
+        }
+    }
+    lcd_fb_col = 0;
+    lcd_fb_row = 0;
+    lcd_fb_cursor = 0xFF;
+    lcd_fb_clears++;
+}
+
+// Sync the shadow with a freshly cleared LCD, call after initialize()
+void lcd_fb_init(void) {
+    lcd_fb_clear();
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            lcd_shadow[r][c] = ' ';
+        }
+    }
+    lcd_cursor_at = 0xFF;
+}
+
+// Set the position the next lcd_fb_print() writes to
+void lcd_fb_setCursor(uint8_t col, uint8_t row) {
+    lcd_fb_col = col;
+    lcd_fb_row = row;
+}
+
+// Underline a cell with the HD44780 cursor, e.g. the field being edited.
+// lcd_fb_clear() hides it again
+void lcd_fb_showCursor(uint8_t col, uint8_t row) {
+    lcd_fb_cursor = row * LCD_COLS + col;
+}
+
+// Write a string into the frame, text past the end of the row is dropped
+void lcd_fb_print(const char *str) {
+    while (*str && lcd_fb_col < LCD_COLS && lcd_fb_row < LCD_ROWS) {
+        lcd_frame[lcd_fb_row][lcd_fb_col++] = *str++;
+    }
+}
+
+// Write one character code (e.g. a glyph from Glyph.h) into the frame
+void lcd_fb_write(uint8_t c) {
+    if (lcd_fb_col < LCD_COLS && lcd_fb_row < LCD_ROWS) {
+        lcd_frame[lcd_fb_row][lcd_fb_col++] = c;
+    }
+}
+
+// Like lcd_fb_print() for a string stored in flash
+void lcd_fb_print_P(const char *str) {
+    char c;
+    while ((c = pgm_read_byte(str++)) && lcd_fb_col < LCD_COLS && lcd_fb_row < LCD_ROWS) {
+        lcd_frame[lcd_fb_row][lcd_fb_col++] = c;
+    }
+}
+
+// Replace the frame with a flash screen whose rows are separated by '\n'.
+// A screen with fewer rows than the panel is centred vertically
+void lcd_fb_screen_P(const char *screen) {
+    char c;
+    uint8_t rows = 1;
+    for (const char *p = screen; (c = pgm_read_byte(p)); p++) {
+        rows += c == '\n';
+    }
+    lcd_fb_clear();
+    if (rows < LCD_ROWS) {
+        lcd_fb_setCursor(0, (LCD_ROWS - rows) / 2);
+    }
+    while ((c = pgm_read_byte(screen++))) {
+        if (c == '\n') {
+            lcd_fb_setCursor(0, lcd_fb_row + 1);
+        } else if (lcd_fb_col < LCD_COLS && lcd_fb_row < LCD_ROWS) {
+            lcd_frame[lcd_fb_row][lcd_fb_col++] = c;
+        }
+    }
+}
+
+// Bring the LCD's underline cursor in line with lcd_fb_cursor. It follows
+// the address counter, so after any write it has to be parked again (the
+// driver skips that when nothing moved it)
+void lcd_fb_sync_cursor(void) {
+    if ((lcd_fb_cursor == 0xFF) != (lcd_cursor_at == 0xFF)) {
+        lcd_command(lcd_fb_cursor == 0xFF ? 0x0C : 0x0E); // Display on, cursor off/on
+    }
+    if (lcd_fb_cursor != 0xFF) {
+        lcd_setCursor(lcd_fb_cursor % LCD_COLS, lcd_fb_cursor / LCD_COLS);
+    }
+    lcd_cursor_at = lcd_fb_cursor;
+}
+
+// Returns 1 once after the driver restarted the display (see lcd_restart()),
+// which blanks it and hides the cursor, so the shadow no longer holds
+uint8_t lcd_fb_lost(void) {
+    if (lcd_fb_reinits == lcd_reinits) {
+        return 0;
+    }
+    lcd_fb_reinits = lcd_reinits;
+    lcd_cursor_at = 0xFF;
+    return 1;
+}
+
+// Write an 8 row bitmap from flash into a CGRAM slot and remember it, so a
+// restarted display can get it back. This leaves the LCD address counter in
+// CGRAM, the next lcd_setCursor() is always sent
+void lcd_fb_upload(uint8_t slot, const uint8_t *bitmap) {
+    lcd_begin();
+    lcd_command(0x40 | (slot << 3)); // Set CGRAM address
+    for (uint8_t row = 0; row < 8; row++) {
+        lcd_send(pgm_read_byte(&bitmap[row]), LCD_RS);
+    }
+    lcd_end();
+    lcd_cgram[slot] = bitmap;
+}
+
+// Put back what the display showed before a restart, from the shadow:
+// CGRAM slots, every cell and the underline cursor
+void lcd_fb_restore(void) {
+    lcd_begin();
+    for (uint8_t slot = 0; slot < 8; slot++) {
+        if (lcd_cgram[slot]) {
+            lcd_fb_upload(slot, lcd_cgram[slot]);
+        }
+    }
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        lcd_setCursor(0, r);
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            lcd_send(lcd_shadow[r][c], LCD_RS);
+        }
+    }
+    lcd_fb_sync_cursor();
+    lcd_end();
+}
+
+// Periodic check for the main loop, about once a second is plenty (~50us
+// when all is well). A display that stopped answering, was swapped or
+// reset by a brownout is restarted and restored without a power cycle
+void lcd_fb_keepalive(void) {
+    if (lcd_check()) {
+        lcd_restart();
+    }
+    if (lcd_fb_lost()) {
+        lcd_fb_restore();
+    }
+}
+
+// Send the changed cells to the LCD. The HD44780 address counter moves on
+// by itself after each character, so a cursor command is only needed to
+// jump over two or more unchanged cells (one clean cell is cheaper to resend).
+// After a display restart the shadow is restored first
+void lcd_render(void) {
+    lcd_begin();
+    if (lcd_fb_lost()) {
+        lcd_fb_restore();
+    }
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        uint8_t pos = 0xFF; // Column the LCD cursor is at on this row, 0xFF = unknown
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            if (lcd_frame[r][c] == lcd_shadow[r][c]) {
+                continue;
+            }
+            if (pos != 0xFF && c == pos + 1) {
+                lcd_send(lcd_frame[r][pos], LCD_RS); // Rewrite the single clean cell
+                pos++;
+            }
+            if (c != pos) {
+                lcd_setCursor(c, r); // Dropped by the driver if the counter is there
+            }
+            lcd_send(lcd_frame[r][c], LCD_RS);
+            lcd_shadow[r][c] = lcd_frame[r][c];
+            pos = c + 1;
+        }
+    }
+    lcd_fb_sync_cursor();
+    lcd_end();
+}
+
+// Show a fixed screen by streaming its precompiled bytes from ScreenBlobs.h
+// in one go, and bring the frame and shadow in line with what it draws
+void lcd_fb_blit_P(const char *screen, const uint8_t *data, uint16_t len) {
+    lcd_fb_screen_P(screen);
+    memcpy(lcd_shadow, lcd_frame, sizeof(lcd_shadow));
+    lcd_blit_P(data, len);
+    if (lcd_fb_lost()) {
+        lcd_fb_restore(); // Mainly for the CGRAM, the cells were just sent
+    }
+    lcd_fb_sync_cursor();
+}
+
+// lcd_show_screen(SCREEN_MODES) for any SCREEN_x in Screens.h
+#define lcd_show_screen(screen) lcd_fb_blit_P(screen, screen##_BYTES, sizeof(screen##_BYTES))
+
+#endif // LCDBUFFER_H
@@ -0,0 +1,31 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "LCDBuffer.h"
+
+// Where each part of the kiosk's screens goes on the configured panel
+// (LCD_COLS x LCD_ROWS). The draw functions in led.c only use these, so a
+// screen is described once for every geometry. A 2 row panel shows the
+// order and the detail views (big digits, pump bars) one after the other,
+// a 4 row panel shows the detail under the order and never has to flip
+
+#define LAYOUT_ORDER_ROW   0              // The four fruits with their percentages
+#define LAYOUT_STATUS_ROW  1              // Budget left and key hint
+#define LAYOUT_FIELD       (LCD_COLS / 4) // Width of one fruit in the order row
+#define LAYOUT_HINT_COL    (LCD_COLS - 6) // Key hint, right of the status row
+
+#if LCD_ROWS >= 4
+#define LAYOUT_SPLIT       0              // Detail shares the screen with the order
+#define LAYOUT_DETAIL_ROW  2              // First of the two detail rows
+#else
+#define LAYOUT_SPLIT       1              // Detail replaces the order
+#define LAYOUT_DETAIL_ROW  0
+#endif
+
+// Dispense progress, in the two detail rows: the running pump's icon and
+// bar, then the whole order's bar and the seconds left
+#define LAYOUT_PUMP_BAR    (LCD_COLS - 2)
+#define LAYOUT_TOTAL_BAR   (LCD_COLS - 5)
+#define LAYOUT_ETA_COL     (LCD_COLS - 4)
+
+#endif // LAYOUT_H
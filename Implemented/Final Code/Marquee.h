@@ -0,0 +1,83 @@
+#ifndef MARQUEE_H
+#define MARQUEE_H
+
+#include "LCDBuffer.h"
+
+// Scrolls a flash string that is longer than its window through one row of
+// the frame, by drawing it at a moving offset (the HD44780 display shift
+// would move every row). Nothing here waits: the caller passes the time in
+// ms and renders when marquee_tick() says the frame changed, so input is
+// handled between steps. One marquee is on screen at a time
+#define MARQUEE_STEP_MS 250   // Time per character
+#define MARQUEE_HOLD_MS 1000  // Pause with the start of the text showing
+#define MARQUEE_GAP 3         // Blanks between the end and the repeat
+
+const char *marquee_text = 0; // Flash string shown, NULL = none
+uint8_t marquee_len;
+uint8_t marquee_col;
+uint8_t marquee_row;
+uint8_t marquee_width;
+uint8_t marquee_pos;          // Index of the first character shown
+uint8_t marquee_screen;       // lcd_fb_clears when it was drawn
+uint16_t marquee_due;         // Time of the next step
+
+// Draw the window at the current offset into the frame
+void marquee_draw(void) {
+    uint8_t i = marquee_pos;
+    lcd_fb_setCursor(marquee_col, marquee_row);
+    for (uint8_t n = 0; n < marquee_width; n++) {
+        lcd_fb_write(i < marquee_len ? pgm_read_byte(marquee_text + i) : ' ');
+        if (++i == marquee_len + MARQUEE_GAP) {
+            i = 0;
+        }
+    }
+}
+
+// Move on one character if a step is due, 1 = it moved
+uint8_t marquee_step(uint16_t now) {
+    if (marquee_len <= marquee_width || (int16_t)(now - marquee_due) < 0) {
+        return 0; // Fits, or not time yet
+    }
+    if (++marquee_pos == marquee_len + MARQUEE_GAP) {
+        marquee_pos = 0;
+    }
+    marquee_due = now + (marquee_pos ? MARQUEE_STEP_MS : MARQUEE_HOLD_MS);
+    return 1;
+}
+
+// Put text in a window of `width` cells from (col, row) while drawing a
+// screen. Text that fits is printed as is. Calling it again with the same
+// text and place (e.g. each time the screen is redrawn) keeps scrolling
+// where it was instead of starting over
+void marquee_show(uint8_t col, uint8_t row, uint8_t width, const char *text, uint16_t now) {
+    if (text != marquee_text || col != marquee_col || row != marquee_row || width != marquee_width) {
+        marquee_text = text;
+        marquee_len = strlen_P(text);
+        marquee_col = col;
+        marquee_row = row;
+        marquee_width = width;
+        marquee_pos = 0;
+        marquee_due = now + MARQUEE_HOLD_MS;
+    } else {
+        marquee_step(now);
+    }
+    marquee_screen = lcd_fb_clears;
+    marquee_draw();
+}
+
+// Call from the loop of a screen that is not redrawn all the time. Returns
+// 1 when the frame changed and wants lcd_render(). Once the screen has been
+// replaced (lcd_fb_clear() was called since) the marquee is dropped, so it
+// cannot come back when the 8-bit clear count wraps round to its screen
+uint8_t marquee_tick(uint16_t now) {
+    if (marquee_text && marquee_screen != lcd_fb_clears) {
+        marquee_text = 0;
+    }
+    if (!marquee_text || !marquee_step(now)) {
+        return 0;
+    }
+    marquee_draw();
+    return 1;
+}
+
+#endif // MARQUEE_H
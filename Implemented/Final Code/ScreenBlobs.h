@@ -0,0 +1,101 @@
+// Generated by genscreens.py from Screens.h (16x2), do not edit
+#ifndef SCREENBLOBS_H
+#define SCREENBLOBS_H
+
+#include <avr/pgmspace.h>
+
+#if LCD_COLS != 16 || LCD_ROWS != 2
+#error "ScreenBlobs.h is for a 16x2 panel, run genscreens.py with --cols/--rows"
+#endif
+
+const uint8_t SCREEN_MODES_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x3D, 0x39, 0x1D, 0x19, 0x2D, 0x29, 0xED, 0xE9,
+    0x2D, 0x29, 0x0D, 0x09, 0x4D, 0x49, 0x1D, 0x19, 0x7D, 0x79, 0x5D, 0x59,
+    0x7D, 0x79, 0x4D, 0x49, 0x6D, 0x69, 0xFD, 0xF9, 0x2D, 0x29, 0x0D, 0x09,
+    0x4D, 0x49, 0xDD, 0xD9, 0x6D, 0x69, 0xFD, 0xF9, 0x6D, 0x69, 0x4D, 0x49,
+    0x6D, 0x69, 0x5D, 0x59, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x3D, 0x39, 0x2D, 0x29, 0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0x0D, 0x09,
+    0x4D, 0x49, 0xDD, 0xD9, 0x6D, 0x69, 0x1D, 0x19, 0x6D, 0x69, 0xED, 0xE9,
+    0x7D, 0x79, 0x5D, 0x59, 0x6D, 0x69, 0x1D, 0x19, 0x6D, 0x69, 0xCD, 0xC9,
+    0x2D, 0x29, 0x0D, 0x09, 0x4D, 0x49, 0xDD, 0xD9, 0x6D, 0x69, 0xFD, 0xF9,
+    0x6D, 0x69, 0x4D, 0x49, 0x6D, 0x69, 0x5D, 0x59, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+const uint8_t SCREEN_PROCESSING_AUTO_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x5D, 0x59, 0x0D, 0x09, 0x7D, 0x79, 0x2D, 0x29,
+    0x6D, 0x69, 0xFD, 0xF9, 0x6D, 0x69, 0x3D, 0x39, 0x6D, 0x69, 0x5D, 0x59,
+    0x7D, 0x79, 0x3D, 0x39, 0x7D, 0x79, 0x3D, 0x39, 0x6D, 0x69, 0x9D, 0x99,
+    0x6D, 0x69, 0xED, 0xE9, 0x6D, 0x69, 0x7D, 0x79, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x4D, 0x49, 0x1D, 0x19, 0x7D, 0x79, 0x5D, 0x59, 0x7D, 0x79, 0x4D, 0x49,
+    0x6D, 0x69, 0xFD, 0xF9, 0x2D, 0x29, 0x0D, 0x09, 0x4D, 0x49, 0xDD, 0xD9,
+    0x6D, 0x69, 0xFD, 0xF9, 0x6D, 0x69, 0x4D, 0x49, 0x6D, 0x69, 0x5D, 0x59,
+    0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0xED, 0xE9,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+const uint8_t SCREEN_CHOOSE_PERCENTAGES_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x5D, 0x59, 0x3D, 0x39, 0x6D, 0x69, 0x5D, 0x59,
+    0x6D, 0x69, 0xCD, 0xC9, 0x6D, 0x69, 0x5D, 0x59, 0x6D, 0x69, 0x3D, 0x39,
+    0x7D, 0x79, 0x4D, 0x49, 0x2D, 0x29, 0x0D, 0x09, 0x7D, 0x79, 0x4D, 0x49,
+    0x6D, 0x69, 0x8D, 0x89, 0x6D, 0x69, 0x5D, 0x59, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x5D, 0x59, 0x0D, 0x09, 0x6D, 0x69, 0x5D, 0x59, 0x7D, 0x79, 0x2D, 0x29,
+    0x6D, 0x69, 0x3D, 0x39, 0x6D, 0x69, 0x5D, 0x59, 0x6D, 0x69, 0xED, 0xE9,
+    0x7D, 0x79, 0x4D, 0x49, 0x6D, 0x69, 0x1D, 0x19, 0x6D, 0x69, 0x7D, 0x79,
+    0x6D, 0x69, 0x5D, 0x59, 0x7D, 0x79, 0x3D, 0x39, 0x2D, 0x29, 0xED, 0xE9,
+    0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+const uint8_t SCREEN_ENJOY_DRINK_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x4D, 0x49, 0x5D, 0x59, 0x6D, 0x69, 0xED, 0xE9,
+    0x6D, 0x69, 0xAD, 0xA9, 0x6D, 0x69, 0xFD, 0xF9, 0x7D, 0x79, 0x9D, 0x99,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x5D, 0x59, 0x9D, 0x99, 0x6D, 0x69, 0xFD, 0xF9, 0x7D, 0x79, 0x5D, 0x59,
+    0x7D, 0x79, 0x2D, 0x29, 0x2D, 0x29, 0x0D, 0x09, 0x6D, 0x69, 0x4D, 0x49,
+    0x7D, 0x79, 0x2D, 0x29, 0x6D, 0x69, 0x9D, 0x99, 0x6D, 0x69, 0xED, 0xE9,
+    0x6D, 0x69, 0xBD, 0xB9, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+const uint8_t SCREEN_PROCESSING_MANUAL_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x5D, 0x59, 0x0D, 0x09, 0x7D, 0x79, 0x2D, 0x29,
+    0x6D, 0x69, 0xFD, 0xF9, 0x6D, 0x69, 0x3D, 0x39, 0x6D, 0x69, 0x5D, 0x59,
+    0x7D, 0x79, 0x3D, 0x39, 0x7D, 0x79, 0x3D, 0x39, 0x6D, 0x69, 0x9D, 0x99,
+    0x6D, 0x69, 0xED, 0xE9, 0x6D, 0x69, 0x7D, 0x79, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x4D, 0x49, 0xDD, 0xD9, 0x6D, 0x69, 0x1D, 0x19, 0x6D, 0x69, 0xED, 0xE9,
+    0x7D, 0x79, 0x5D, 0x59, 0x6D, 0x69, 0x1D, 0x19, 0x6D, 0x69, 0xCD, 0xC9,
+    0x2D, 0x29, 0x0D, 0x09, 0x4D, 0x49, 0xDD, 0xD9, 0x6D, 0x69, 0xFD, 0xF9,
+    0x6D, 0x69, 0x4D, 0x49, 0x6D, 0x69, 0x5D, 0x59, 0x2D, 0x29, 0xED, 0xE9,
+    0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0xED, 0xE9, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+const uint8_t SCREEN_ONE_FRUIT_BYTES[] PROGMEM = {
+    0x8C, 0x88, 0x0C, 0x08, 0x5D, 0x59, 0x3D, 0x39, 0x6D, 0x69, 0x5D, 0x59,
+    0x6D, 0x69, 0xCD, 0xC9, 0x6D, 0x69, 0x5D, 0x59, 0x6D, 0x69, 0x3D, 0x39,
+    0x7D, 0x79, 0x4D, 0x49, 0x2D, 0x29, 0x0D, 0x09, 0x6D, 0x69, 0xFD, 0xF9,
+    0x6D, 0x69, 0xED, 0xE9, 0x6D, 0x69, 0xCD, 0xC9, 0x7D, 0x79, 0x9D, 0x99,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0xCC, 0xC8, 0x0C, 0x08,
+    0x4D, 0x49, 0xFD, 0xF9, 0x6D, 0x69, 0xED, 0xE9, 0x6D, 0x69, 0x5D, 0x59,
+    0x2D, 0x29, 0x0D, 0x09, 0x4D, 0x49, 0x6D, 0x69, 0x7D, 0x79, 0x2D, 0x29,
+    0x7D, 0x79, 0x5D, 0x59, 0x6D, 0x69, 0x9D, 0x99, 0x7D, 0x79, 0x4D, 0x49,
+    0x2D, 0x29, 0x1D, 0x19, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09, 0x2D, 0x29, 0x0D, 0x09,
+    0x2D, 0x29, 0x0D, 0x09,
+};
+
+#endif // SCREENBLOBS_H
@@ -0,0 +1,45 @@
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <avr/pgmspace.h>
+
+// Fixed screens, kept in flash. Rows are separated by '\n', draw them with
+// lcd_fb_screen_P()
+const char SCREEN_MODES[] PROGMEM              = "1. Auto Mode\n2. Manual Mode";
+const char SCREEN_PROCESSING_AUTO[] PROGMEM    = "Processing\nAuto Mode...";
+const char SCREEN_CHOOSE_PERCENTAGES[] PROGMEM = "Select the\nPercentages..";
+const char SCREEN_ENJOY_DRINK[] PROGMEM        = "Enjoy\nYour drink";
+const char SCREEN_PROCESSING_MANUAL[] PROGMEM  = "Processing\nManual Mode...";
+const char SCREEN_ONE_FRUIT[] PROGMEM          = "Select only\nOne Fruit!";
+
+// Messages longer than a row, scrolled with marquee_show()
+const char MSG_AUTO_MODE[] PROGMEM   = "Auto Mode";
+const char MSG_TOTAL_LIMIT[] PROGMEM = "Total should not exceed 100%";
+
+// Fruit names, indexed like percentages[] and the motor pins
+const char FRUIT_PINEAPPLE[] PROGMEM = "PINEAPPLE";
+const char FRUIT_MANGO[] PROGMEM     = "MANGO";
+const char FRUIT_APPLE[] PROGMEM     = "APPLE";
+const char FRUIT_ORANGE[] PROGMEM    = "ORANGE";
+
+const char * const fruits[] PROGMEM = {FRUIT_PINEAPPLE, FRUIT_MANGO, FRUIT_APPLE, FRUIT_ORANGE};
+
+// 5x8 fruit icons for glyph_use(), same order as fruits[]
+const uint8_t fruitIcons[4][8] PROGMEM = {
+    {0x0A, 0x04, 0x0E, 0x15, 0x1F, 0x15, 0x1F, 0x0E}, // Pineapple
+    {0x00, 0x06, 0x0F, 0x1F, 0x1E, 0x1C, 0x18, 0x00}, // Mango
+    {0x04, 0x04, 0x1B, 0x1F, 0x1F, 0x1F, 0x0E, 0x00}, // Apple
+    {0x02, 0x04, 0x0E, 0x1F, 0x1F, 0x1F, 0x0E, 0x00}, // Orange
+};
+
+// Flash address of a fruit's name
+const char *fruitName(uint8_t fruit) {
+    return (const char *)pgm_read_word(&fruits[fruit]);
+}
+
+// Flash address of a fruit's icon bitmap
+const uint8_t *fruitIcon(uint8_t fruit) {
+    return fruitIcons[fruit];
+}
+
+#endif // SCREENS_H
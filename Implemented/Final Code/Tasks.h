@@ -0,0 +1,100 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "Clock.h"
+
+// Cooperative scheduler over a static table of tasks. A task is a function
+// that does a little work and returns (never waits); it runs every `period`
+// ms, when signalled (from code or an ISR), or both. The table order is
+// the priority: each tasks_poll() runs the first task that is ready, so a
+// task further down only runs when everything above it is idle.
+//
+//   task_t tasks[] = {
+//       TASK(inputTask, 50, 25),   // Every 50ms, may start up to 25ms late
+//       TASK(uiTask, 0, 50),       // Only when signalled
+//   };
+//   task_signal(&tasks[1]);
+//   while (1) tasks_poll(tasks, 2);
+//
+// A run that starts more than `deadline` ms after it was due (or signalled)
+// counts as a miss. A periodic task that falls a whole period behind skips
+// the runs it missed instead of running back to back
+
+typedef struct task {
+    void (*run)(void);
+    uint16_t period;           // ms between runs, 0 = only when signalled
+    uint16_t deadline;         // ms a run may start late without a miss
+    uint32_t due;              // clock_millis() of the next periodic run
+    uint32_t signalled_at;     // clock_millis() of the pending signal
+    volatile uint8_t signalled;
+    uint16_t runs;             // Since tasks_stats_reset()
+    uint16_t misses;
+    uint16_t max_ticks;        // Longest run in clock_ticks()
+} task_t;
+
+#define TASK(run, period, deadline) {run, period, deadline}
+
+// Ask for a run of `task` on the next tasks_poll(), safe from ISRs.
+// Signals before it runs are merged into one run
+void task_signal(task_t *task) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (!task->signalled) {
+            task->signalled_at = clock_ms;
+            task->signalled = 1;
+        }
+    }
+}
+
+// Run the highest priority task that is ready, 1 = one ran
+uint8_t tasks_poll(task_t *table, uint8_t count) {
+    uint32_t now = clock_millis();
+    for (uint8_t i = 0; i < count; i++) {
+        task_t *t = &table[i];
+        uint32_t late;
+        uint32_t start;
+        uint32_t ticks;
+
+        if (t->signalled) {
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                late = now - t->signalled_at;
+                t->signalled = 0;
+            }
+        } else if (t->period && (int32_t)(now - t->due) >= 0) {
+            late = now - t->due;
+        } else {
+            continue;
+        }
+        if (t->period && (int32_t)(now - t->due) >= 0) {
+            t->due = now - t->due >= t->period ? now + t->period : t->due + t->period;
+        }
+        if (late > t->deadline && t->misses != 0xFFFF) {
+            t->misses++;
+        }
+
+        start = clock_ticks();
+        t->run();
+        ticks = clock_ticks() - start;
+
+        if (ticks > t->max_ticks) {
+            t->max_ticks = ticks > 0xFFFF ? 0xFFFF : ticks;
+        }
+        if (t->runs != 0xFFFF) {
+            t->runs++;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// Start counting runs, misses and the longest run afresh
+void tasks_stats_reset(task_t *table, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        table[i].runs = 0;
+        table[i].misses = 0;
+        table[i].max_ticks = 0;
+    }
+}
+
+#endif // TASKS_H
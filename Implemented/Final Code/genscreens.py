@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Precompile the fixed screens in Screens.h into PCF8574 byte streams.
+
+Every SCREEN_x string becomes SCREEN_x_BYTES[] in flash: for each row a
+set-DDRAM-address command followed by the row text padded with spaces,
+each byte already split into E-high/E-low nibble writes with the
+backlight and RS bits set. lcd_blit_P() sends such a table as is.
+Screens with fewer rows than the panel are centred vertically, the same
+way lcd_fb_screen_P() lays them out.
+
+usage: genscreens.py Screens.h [--cols 16] [--rows 2] > ScreenBlobs.h
+"""
+
+import argparse
+import re
+import sys
+
+# Must match the control bits in LCD.h
+LCD_BACKLIGHT = 0x08
+LCD_ENABLE = 0x04
+LCD_RS = 0x01
+
+
+def row_offsets(cols):
+    """DDRAM address of each row, as lcd_setCursor() computes it."""
+    return (0x00, 0x40, cols, 0x40 + cols)
+
+SCREEN_RE = re.compile(r'const char (SCREEN_\w+)\[\] PROGMEM\s*=\s*"((?:[^"\\]|\\.)*)";')
+
+
+def nibbles(value, mode):
+    """The four bytes lcd_send() writes for one command or character."""
+    out = []
+    for nibble in (value & 0xF0, (value << 4) & 0xF0):
+        data = nibble | mode | LCD_BACKLIGHT
+        out += [data | LCD_ENABLE, data & ~LCD_ENABLE & 0xFF]
+    return out
+
+
+def screen_bytes(text, cols, rows):
+    lines = text.split("\n")
+    if len(lines) > rows:
+        raise ValueError("%d rows, display has %d" % (len(lines), rows))
+    top = (rows - len(lines)) // 2
+    lines = [""] * top + lines + [""] * (rows - len(lines) - top)
+    out = []
+    for row, line in enumerate(lines):
+        if len(line) > cols:
+            raise ValueError("row %d is %d characters, display has %d" % (row, len(line), cols))
+        out += nibbles(0x80 | row_offsets(cols)[row], 0)
+        for ch in line.ljust(cols):
+            out += nibbles(ord(ch), LCD_RS)
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("screens")
+    parser.add_argument("--cols", type=int, default=16)
+    parser.add_argument("--rows", type=int, default=2)
+    args = parser.parse_args()
+
+    with open(args.screens) as f:
+        screens = SCREEN_RE.findall(f.read())
+
+    out = sys.stdout
+    out.write("// Generated by genscreens.py from %s (%dx%d), do not edit\n"
+              % (args.screens, args.cols, args.rows))
+    out.write("#ifndef SCREENBLOBS_H\n#define SCREENBLOBS_H\n\n")
+    out.write("#include <avr/pgmspace.h>\n\n")
+    out.write("#if LCD_COLS != %d || LCD_ROWS != %d\n" % (args.cols, args.rows))
+    out.write("#error \"ScreenBlobs.h is for a %dx%d panel, run genscreens.py with --cols/--rows\"\n"
+              % (args.cols, args.rows))
+    out.write("#endif\n")
+    for name, literal in screens:
+        text = literal.encode().decode("unicode_escape")
+        try:
+            data = screen_bytes(text, args.cols, args.rows)
+        except ValueError as e:
+            sys.exit("%s: %s" % (name, e))
+        out.write("\nconst uint8_t %s_BYTES[] PROGMEM = {\n" % name)
+        for i in range(0, len(data), 12):
+            out.write("    " + ", ".join("0x%02X" % b for b in data[i:i + 12]) + ",\n")
+        out.write("};\n")
+    out.write("\n#endif // SCREENBLOBS_H\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -2,7 +2,26 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <util/delay.h>
-#include "LCD.h"
+#include "Dispense.h"
+#include "Clock.h"
+#include "Tasks.h"
+#include "Debug.h"
+
+// The bus and LCD driver time latencies and waits with the Timer0 stamp
+#define I2C_CLOCK() clock_ticks()
+#define I2C_CLOCK_CYCLES 64
+
+#include "LCDBuffer.h"
+#include "Layout.h"
+#include "Glyph.h"
+#include "BigDigit.h"
+#include "Marquee.h"
+#include "Format.h"
+#include "Screens.h"
+#include "ScreenBlobs.h"
+
+// An info screen's draw function, see uiShowInfo()
+typedef void (*ScreenFn)(void);
 
 // Function prototypes
 void setup();
@@ -13,107 +32,514 @@ uint8_t isEncoderPressed();
 void displayModes();
 void displayProcessing();
 void displayChoosePercentages();
-void displayExceed100();
-void displayFruitinAuto(char *fruit, uint8_t percentage);
-void displayFruitinManual(char *fruit);
-void displayOrderComplete();
+void displayTotalLimit();
+void displayProcessingManual();
+void displayOneFruit();
+void drawOrderRow();
+void displayMixEditor();
+void displayBigPercentage();
+void displayPercentageStep();
+void displayFruitinManual(uint8_t fruit);
+void displayDispenseProgress(uint8_t motor, uint16_t pumpTime, uint16_t left);
 void displayEnjoyDrink();
-void turnOnMotor(uint8_t motor, uint8_t percentage);
+void frameChanged();
 void turnOffMotors();
 int8_t readEncoder();
-void checkPercentageSum();
-void interruptSwitch();
+uint8_t percentageTotal();
+void startOrder(uint8_t manual);
 uint8_t isEncoderPressed();
 uint16_t getDelayForPercentage(uint8_t percentage);
-void manualMode();  // Function prototype for manual mode
-void autoSelection();
+void uiEnter(uint8_t state);
+void uiDrawInfo();
+void uiShowInfo(const ScreenFn *screens, uint8_t count, uint8_t next);
+void uiShowIntro(const ScreenFn *screens, uint8_t count, uint8_t next);
+void uiTask();
+void inputTask();
+void dispenseTask();
+void displayTask();
+void debugReport();
 // Variables
-char *fruits[] = {"PINEAPPLE", "MANGO", "APPLE", "ORANGE"};
-uint8_t fruitIndex = 0;
 uint8_t percentages[4] = {0, 0, 0, 0};  // Array to store percentages for each fruit
-uint8_t percentage = 0;
-uint8_t selectingPercentage = 0;
-uint8_t switch1Pressed = 0;
+uint8_t editFruit = 0;  // Fruit the encoder is adjusting in the mix editor
+uint8_t manualFruit = 0;  // Fruit shown in manual mode
+uint8_t bigView = 0;  // The big percentage is showing instead of the mix editor
+uint32_t bigViewAt = 0;  // clock_millis() of the encoder step that showed it
+uint32_t manualStepAt = 0;  // clock_millis() of the last fruit change in manual mode
+
+#define BIG_VIEW_MS 1500  // Back to the mix editor this long after the last step
+#define INPUT_MS 50       // Switch and encoder sampling, a press must read on two samples
+#define MANUAL_STEP_MS 200  // Manual mode takes one encoder step per this long
+#define INFO_MS 4000      // Time each info screen stays up, unless dismissed
+
+// Info screens on/off and the repeat customer window, set in the Makefile
+#ifndef INFO_SCREENS
+#define INFO_SCREENS 1
+#endif
+#ifndef INFO_REPEAT_MS
+#define INFO_REPEAT_MS 120000UL
+#endif
+uint16_t dispenseTotal = 0;  // ms of pumping in the current order
+uint16_t dispenseDone = 0;   // ms of it already poured by earlier pumps
 
 volatile uint8_t stopManualMode = 0;  // Flag for stopping manual mode
 
+#define LCD_CHECK_MS 1000  // How often the LCD is checked to still be there
+
+#define DEBUG_REPORT_MS 5000  // Period of the LCD counter report on the debug channel
+#define DEBUG_STEP_MS 10      // How often the report being sent is topped up
+#define DEBUG_FIELD_MAX 56    // Longest field, " hist=" and its 8 numbers
+uint32_t debugReportAt = 0;  // clock_millis() of the last report
+
+// The kiosk's work, split into tasks that each do a little and return.
+// Highest priority first: the pumps, then input, the screens' logic, and
+// sending the frame to the LCD. Periods and deadlines in ms
+enum {TASK_DISPENSE, TASK_INPUT, TASK_UI, TASK_DISPLAY, TASK_LCD_CHECK, TASK_DEBUG, TASK_COUNT};
+task_t tasks[TASK_COUNT] = {
+    TASK(dispenseTask, 20, 20),        // Next pump of the order, progress
+    TASK(inputTask, INPUT_MS, 25),     // Switch presses and encoder steps
+    TASK(uiTask, 50, 50),              // Screens; signalled by input and the pumps
+    TASK(displayTask, 50, 100),        // Frame to the LCD; signalled by frameChanged()
+    TASK(lcd_fb_keepalive, LCD_CHECK_MS, LCD_CHECK_MS), // Bring back an unplugged or browned out LCD
+    TASK(debugReport, DEBUG_STEP_MS, 100),  // A few fields of the report at a time
+};
+
+#if DEBUG_UART
+#if LCD_TWI_ASYNC && I2C_TIMED
+#define DEBUG_I2C_LINES I2C_PRIOS
+#else
+#define DEBUG_I2C_LINES 0
+#endif
+#define DEBUG_LINES (1 + DEBUG_I2C_LINES + TASK_COUNT)
+
+// The counters of the report being sent, copied when it started
+struct {
+    uint32_t ms;
+    uint16_t txns;
+    uint32_t bytes;
+    uint16_t nacks;
+    uint16_t retries;
+    uint16_t timeouts;
+    uint16_t recoveries;
+    uint16_t reinits;
+    uint32_t busy;
+    uint16_t elided;
+    uint8_t queue_hwm;
+#if DEBUG_I2C_LINES
+    uint32_t lat_max[I2C_PRIOS];
+    uint16_t hist[I2C_PRIOS][I2C_HIST_BUCKETS];
+#endif
+    uint16_t runs[TASK_COUNT];
+    uint16_t max_ticks[TASK_COUNT];
+    uint16_t misses[TASK_COUNT];
+} debugSnap;
+uint8_t debugLine = 0xFF;  // Line of the report being sent, 0xFF = none
+uint8_t debugField = 0;    // Next field on that line
+
+void debugSnapshot(uint32_t now);
+uint8_t debugSendField(uint8_t line, uint8_t field);
+#endif
+
+// Screen flow
+enum {UI_MODES, UI_INFO, UI_EDITOR, UI_DISPENSE, UI_MANUAL};
+uint8_t uiState = UI_MODES;
+
+// Info screens shown one after the other before a mode starts, and after
+// an order. Each is up for INFO_MS, then uiNext begins; any press or
+// encoder step skips the rest of them
+#define INFO_COUNT(screens) (sizeof(screens) / sizeof(screens[0]))
+const ScreenFn autoIntro[] PROGMEM = {displayProcessing, displayChoosePercentages, displayTotalLimit};
+const ScreenFn manualIntro[] PROGMEM = {displayProcessingManual, displayOneFruit};
+const ScreenFn orderDone[] PROGMEM = {displayEnjoyDrink};
+const ScreenFn *infoScreens;  // Sequence being shown
+uint8_t infoCount;
+uint8_t infoStep;             // Screen of it on the LCD
+uint32_t infoAt;              // clock_millis() when it was drawn
+uint8_t uiNext;               // State after the last screen
+uint8_t ordered = 0;          // An order was poured since power up
+uint32_t orderEndedAt;        // clock_millis() when the last one finished
+
+// Input, sampled by inputTask() and taken by uiTask()
+#define INPUT_SWITCH1 0x01
+#define INPUT_SWITCH2 0x02
+#define INPUT_SWITCH3 0x04
+uint8_t inputPresses = 0;  // INPUT_* presses not handled yet
+int8_t inputSteps = 0;     // Encoder steps not handled yet
+
+// The order being poured
+uint8_t orderRunning = 0;
+uint8_t orderManual = 0;   // Poured from manual mode
+uint8_t orderNext = 0;     // Next fruit to look at
+uint8_t pumpRunning = 0;
+uint8_t pumpMotor = 0;
+uint16_t pumpTime = 0;     // ms the running pump was started for
+
+uint8_t framePending = 0;  // Frame drawn, not sent to the LCD yet
+
 int main(void) {
     setup();  // Initialize pins
     initialize();  // Initialize LCD
+    lcd_fb_init();  // Shadow buffer matches the cleared LCD
+    glyph_reset();  // CGRAM holds no glyphs yet
+    uiEnter(UI_MODES);  // Display mode selection at the start
 
     while (1) {
-        displayModes();  // Display mode selection at the start
-
-        // Wait for Switch 1 (PC0) press
-        while (!isSwitch1Pressed()) {
-            // Check if Switch 2 (PC1) is pressed for Manual Mode
-            if (isSwitch2Pressed()) {
-                // Disable Switches for Manual Mode
-                switch1Pressed = 1;  // Disable Switch 1
-                manualMode();        // Go to Manual Mode
+        tasks_poll(tasks, TASK_COUNT);
+    }
+    return 0;
+}
+
+// Switch to a screen state and draw it
+void uiEnter(uint8_t state) {
+    uiState = state;
+    switch (state) {
+        case UI_MODES:
+            displayModes();
+            break;
+        case UI_EDITOR:
+            editFruit = 0;
+            bigView = 0;
+            displayMixEditor();
+            break;
+        case UI_MANUAL:
+            manualFruit = 0;
+            stopManualMode = 0;
+            displayFruitinManual(manualFruit);
+            break;
+    }
+}
+
+// Draw screen `infoStep` of the info sequence
+void uiDrawInfo() {
+    ((ScreenFn)pgm_read_word(&infoScreens[infoStep]))();
+    infoAt = clock_millis();
+}
+
+// Show `count` info screens from a PROGMEM table, then enter `next`
+void uiShowInfo(const ScreenFn *screens, uint8_t count, uint8_t next) {
+    if (!INFO_SCREENS) {
+        uiEnter(next);
+        return;
+    }
+    uiState = UI_INFO;
+    infoScreens = screens;
+    infoCount = count;
+    infoStep = 0;
+    uiNext = next;
+    uiDrawInfo();
+}
+
+// Like uiShowInfo() for the screens that explain a mode, which a customer
+// who has just ordered has read already
+void uiShowIntro(const ScreenFn *screens, uint8_t count, uint8_t next) {
+    if (INFO_REPEAT_MS && ordered && !clock_elapsed(orderEndedAt, INFO_REPEAT_MS)) {
+        uiEnter(next);
+    } else {
+        uiShowInfo(screens, count, next);
+    }
+}
+
+// Screen logic: reacts to presses and encoder steps, and to time passing
+// (info screens, the big digit view). Never waits
+void uiTask() {
+    uint8_t presses = inputPresses;
+    int8_t steps = inputSteps;
+    uint8_t editPercent;
+    inputPresses = 0;
+    inputSteps = 0;
+
+    switch (uiState) {
+        case UI_MODES:
+            if (presses & INPUT_SWITCH1) {
+                uiShowIntro(autoIntro, INFO_COUNT(autoIntro), UI_EDITOR);
+            } else if (presses & INPUT_SWITCH2) {
+                uiShowIntro(manualIntro, INFO_COUNT(manualIntro), UI_MANUAL);  // Go to Manual Mode
             }
-        }
+            break;
+
+        case UI_INFO:
+            if (presses || steps) {
+                uiEnter(uiNext);  // Dismissed, the input itself is not passed on
+            } else if (clock_elapsed(infoAt, INFO_MS)) {
+                if (++infoStep < infoCount) {
+                    uiDrawInfo();
+                } else {
+                    uiEnter(uiNext);
+                }
+            }
+            break;
+
+        // Mix editor: the encoder changes the underlined fruit, its switch
+        // moves to the next fruit, Switch 2 fills the underlined fruit with
+        // whatever is left and Switch 1 confirms the whole mix once. All the
+        // steps since the last pass are applied, 20% each; steps that would
+        // take the total over 100% are skipped, so the mix is always valid
+        case UI_EDITOR:
+            editPercent = percentages[editFruit];
+            for (; steps > 0 && percentageTotal() + 20 <= 100; steps--) {
+                percentages[editFruit] += 20;
+            }
+            for (; steps < 0 && percentages[editFruit] > 0; steps++) {
+                percentages[editFruit] -= 20;
+            }
+            if (percentages[editFruit] != editPercent) {
+                displayPercentageStep();  // Update the displayed percentage
+            } else if (bigView && clock_elapsed(bigViewAt, BIG_VIEW_MS)) {
+                bigView = 0;
+                displayMixEditor();  // Encoder idle, back to the overview
+            }
+            if (presses & INPUT_SWITCH3) {
+                editFruit = (editFruit + 1) & 3;  // Wrap around after ORANGE
+                bigView = 0;
+                displayMixEditor();
+            }
+            if (presses & INPUT_SWITCH2) {
+                percentages[editFruit] += 100 - percentageTotal();
+                bigView = 0;
+                displayMixEditor();
+            }
+            if (presses & INPUT_SWITCH1) {
+                startOrder(0);  // The total never exceeds 100%, go pour it
+            }
+            break;
+
+        case UI_DISPENSE:
+            if (!orderRunning) {
+                percentages[0] = percentages[1] = percentages[2] = percentages[3] = 0;  // Reset percentages
+                ordered = 1;
+                orderEndedAt = clock_millis();
+                uiShowInfo(orderDone, INFO_COUNT(orderDone), UI_MODES);  // Display enjoyment message
+            }
+            break;
+
+        // Manual mode: the encoder picks a fruit, its switch pours it and
+        // the encoder button (stopManualMode) goes back to the modes
+        case UI_MANUAL:
+            if (stopManualMode) {
+                stopManualMode = 0;
+                turnOffMotors();  // Ensure all motors are turned off
+                uiEnter(UI_MODES);
+                break;
+            }
+            if (steps && clock_elapsed(manualStepAt, MANUAL_STEP_MS)) {
+                manualStepAt = clock_millis();
+                manualFruit = (manualFruit + (steps > 0 ? 1 : 3)) & 3;  // Wrap around
+                displayFruitinManual(manualFruit);
+            }
+            if (presses & INPUT_SWITCH3) {
+                percentages[manualFruit] = 100;
+                startOrder(1);
+            }
+            break;
+    }
+}
+
+// Sample the switches and the encoder. A switch counts as pressed once it
+// reads pressed on two samples in a row, and once per press; the UI task
+// is signalled when there is something new
+void inputTask() {
+    static uint8_t last = 0;    // Switches down on the previous sample
+    static uint8_t held = 0;    // Presses already reported, until released
+    uint8_t down = (isSwitch1Pressed() ? INPUT_SWITCH1 : 0)
+                 | (isSwitch2Pressed() ? INPUT_SWITCH2 : 0)
+                 | (isSwitch3Pressed() ? INPUT_SWITCH3 : 0);
+    uint8_t pressed = down & last & ~held;
+    int8_t rotation = readEncoder();
+
+    held = (held | pressed) & down;
+    last = down;
+    inputPresses |= pressed;
+    if (rotation > 0 && inputSteps < 8) {
+        inputSteps++;
+    } else if (rotation < 0 && inputSteps > -8) {
+        inputSteps--;
+    }
+    if (pressed || rotation) {
+        task_signal(&tasks[TASK_UI]);
+    }
+}
 
-        // Disable Switch 1 after the first press
-        switch1Pressed = 1;
+// Start pouring the selected percentages, dispenseTask() does the rest
+void startOrder(uint8_t manual) {
+    dispenseTotal = 0;
+    dispenseDone = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        dispenseTotal += getDelayForPercentage(percentages[i]);
+    }
+    orderManual = manual;
+    orderNext = 0;
+    orderRunning = 1;
+    stopManualMode = 0;
+    uiState = UI_DISPENSE;
+    task_signal(&tasks[TASK_DISPENSE]);
+}
 
-        // Display "Processing.." and other startup messages
-        displayProcessing();
-        _delay_ms(4000);
+// Run the order's pumps one after the other and keep the progress screen
+// up to date. Timer1 switches each pump off on time (Dispense.h), this
+// only starts the next one. In manual mode the encoder button stops the
+// pour; auto orders always run to the end
+void dispenseTask() {
+    uint16_t left;
 
-        displayChoosePercentages();
-        _delay_ms(4000);
+    if (!orderRunning) {
+        return;
+    }
+    if (pumpRunning) {
+        if (orderManual && stopManualMode) {
+            dispense_stop();
+            orderNext = 4;
+        }
+        left = dispense_left();
+        if (left) {
+            displayDispenseProgress(pumpMotor, pumpTime, left);
+            return;
+        }
+        dispenseDone += pumpTime;
+        pumpRunning = 0;
+    }
+    while (orderNext < 4 && percentages[orderNext] == 0) {
+        orderNext++;  // Only pour fruits with a percentage
+    }
+    if (orderNext < 4 && !(orderManual && stopManualMode)) {
+        pumpMotor = orderNext++;
+        pumpTime = getDelayForPercentage(percentages[pumpMotor]);
+        dispense_start(pumpMotor, pumpTime);  // Timer1 turns the motor off after pumpTime ms
+        pumpRunning = 1;
+        displayDispenseProgress(pumpMotor, pumpTime, pumpTime);
+    } else {
+        orderRunning = 0;
+        stopManualMode = 0;
+        task_signal(&tasks[TASK_UI]);
+    }
+}
 
-        lcd_clear();
-        lcd_setCursor(0, 0);
-        lcd_print("Total should not");
-        lcd_setCursor(0, 1);
-        lcd_print("exceed 100%");
-        _delay_ms(4000);
+// The frame was drawn, have displayTask() send it
+void frameChanged() {
+    framePending = 1;
+    task_signal(&tasks[TASK_DISPLAY]);
+}
 
-        // Begin the fruit and percentage selection process
-        displayFruitinAuto(fruits[fruitIndex], percentage);
-        selectingPercentage = 1;  // Enable percentage selection
-	autoSelection();
+// Send the changed cells to the LCD, and scroll a long fruit name
+void displayTask() {
+    if (marquee_tick(clock_millis()) || framePending) {
+        framePending = 0;
+        lcd_render();
     }
-    return 0;
 }
 
+// Send the LCD driver's and the bus's counters for the last DEBUG_REPORT_MS
+// as lines of name=value fields on the debug channel, then start counting
+// afresh. "i2c" lines give per priority class the worst latency and the
+// histogram: transactions under 50, 100, 200 ... 3200us and slower. "task"
+// lines give per task (in table order) its runs, longest run and the runs
+// that started later than its deadline. The counters are copied when a
+// report is due, and each run sends only the fields that fit in the debug
+// buffer, so the other tasks never wait on the serial line
+void debugReport() {
+#if DEBUG_UART
+    if (debugLine == 0xFF) {
+        if (!clock_elapsed(debugReportAt, DEBUG_REPORT_MS)) {
+            return;
+        }
+        debugSnapshot(clock_millis());
+        debugLine = 0;
+        debugField = 0;
+    }
+    while (debugLine != 0xFF && debug_room() >= DEBUG_FIELD_MAX) {
+        if (debugSendField(debugLine, debugField++)) {
+            continue;
+        }
+        debug_print_P(PSTR("\r\n"));
+        debugField = 0;
+        if (++debugLine == DEBUG_LINES) {
+            debugLine = 0xFF;  // Done until the next report is due
+        }
+    }
+#endif
+}
 
-void autoSelection(){
-        while (1) {
-            if (selectingPercentage) {
-                // Read the rotary encoder to adjust the percentage
-                int8_t rotation = readEncoder();
-                if (rotation > 0 && percentage < 100) {
-                    percentage += 20;
-                    displayFruitinAuto(fruits[fruitIndex], percentage);  // Update the displayed percentage
-                } else if (rotation < 0 && percentage > 0) {
-                    percentage -= 20;
-                    displayFruitinAuto(fruits[fruitIndex], percentage);  // Update the displayed percentage
-                }
+#if DEBUG_UART
+// Copy the counters for a report and start counting afresh
+void debugSnapshot(uint32_t now) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        debugSnap.txns = lcd_stat_txns;    // Counted in TWI_vect
+        debugSnap.bytes = i2c_stat_bytes;
+        debugSnap.nacks = i2c_stat_nacks;
+    }
+    debugSnap.ms = now - debugReportAt;
+    debugSnap.retries = lcd_stat_retries;
+    debugSnap.timeouts = i2c_timeouts;
+    debugSnap.recoveries = i2c_recoveries;
+    debugSnap.reinits = lcd_reinits;
+    debugSnap.busy = lcd_stat_busy;
+    debugSnap.elided = lcd_stat_elided;
+#if LCD_TWI_ASYNC
+    debugSnap.queue_hwm = lcd_queue_hwm;
+#endif
+#if DEBUG_I2C_LINES
+    for (uint8_t p = 0; p < I2C_PRIOS; p++) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            memcpy(debugSnap.hist[p], i2c_hist[p], sizeof(debugSnap.hist[p]));
+            debugSnap.lat_max[p] = i2c_lat_max[p];
+        }
+    }
+#endif
+    for (uint8_t t = 0; t < TASK_COUNT; t++) {
+        debugSnap.runs[t] = tasks[t].runs;
+        debugSnap.max_ticks[t] = tasks[t].max_ticks;
+        debugSnap.misses[t] = tasks[t].misses;
+    }
+    debugReportAt = now;
+    lcd_stats_reset();
+    tasks_stats_reset(tasks, TASK_COUNT);
+}
 
-                // Check if the rotary encoder switch is pressed to confirm the percentage and move to the next fruit
-                if (isSwitch3Pressed()) {
-                    _delay_ms(50); // Debounce delay
-                    if (isSwitch3Pressed()) { // Confirm switch press after delay
-                        percentages[fruitIndex] = percentage;  // Store the selected percentage
-                        fruitIndex++;  // Move to the next fruit
-
-                        if (fruitIndex < 4) {
-                            percentage = 0;  // Reset percentage for the next fruit
-                            displayFruitinAuto(fruits[fruitIndex], percentage);  // Display next fruit
-                        } else {
-                            selectingPercentage = 0;  // Disable encoder
-                            checkPercentageSum();  // Check if total exceeds 100
-                            break;  // Exit the inner loop
-                        }
-                    }
-                }
-            }
-            _delay_ms(50);  // Small delay for debouncing
+// Send field `field` of report line `line`, 0 = the line has no more
+uint8_t debugSendField(uint8_t line, uint8_t field) {
+    if (line == 0) {
+        switch (field) {
+            case 0: debug_print_P(PSTR("lcd")); break;
+            case 1: debug_field_P(PSTR("ms"), debugSnap.ms); break;
+            case 2: debug_field_P(PSTR("txns"), debugSnap.txns); break;
+            case 3: debug_field_P(PSTR("bytes"), debugSnap.bytes); break;
+            case 4: debug_field_P(PSTR("nacks"), debugSnap.nacks); break;
+            case 5: debug_field_P(PSTR("retries"), debugSnap.retries); break;
+            case 6: debug_field_P(PSTR("timeouts"), debugSnap.timeouts); break;
+            case 7: debug_field_P(PSTR("recoveries"), debugSnap.recoveries); break;
+            case 8: debug_field_P(PSTR("reinits"), debugSnap.reinits); break;
+            case 9: debug_field_P(PSTR("busy_cycles"), debugSnap.busy * I2C_CLOCK_CYCLES); break;
+            case 10: debug_field_P(PSTR("elided"), debugSnap.elided); break;
+#if LCD_TWI_ASYNC
+            case 11: debug_field_P(PSTR("queue_hwm"), debugSnap.queue_hwm); break;
+#endif
+            default: return 0;
+        }
+        return 1;
+    }
+    line--;
+#if DEBUG_I2C_LINES
+    if (line < I2C_PRIOS) {
+        switch (field) {
+            case 0: debug_print_P(PSTR("i2c")); break;
+            case 1: debug_field_P(PSTR("prio"), line); break;
+            case 2: debug_field_P(PSTR("max_us"), debugSnap.lat_max[line] * I2C_CLOCK_CYCLES / (F_CPU / 1000000UL)); break;
+            case 3: debug_list_P(PSTR("hist"), debugSnap.hist[line], I2C_HIST_BUCKETS); break;
+            default: return 0;
         }
+        return 1;
+    }
+    line -= I2C_PRIOS;
+#endif
+    switch (field) {
+        case 0: debug_print_P(PSTR("task")); break;
+        case 1: debug_field_P(PSTR("id"), line); break;
+        case 2: debug_field_P(PSTR("runs"), debugSnap.runs[line]); break;
+        case 3: debug_field_P(PSTR("max_us"), (uint32_t)debugSnap.max_ticks[line] * CLOCK_US_PER_TICK); break;
+        case 4: debug_field_P(PSTR("misses"), debugSnap.misses[line]); break;
+        default: return 0;
+    }
+    return 1;
 }
+#endif
 
 // Function to set up the button and encoder pins
 void setup() {
@@ -140,6 +566,9 @@ void setup() {
     // Set relay control pins as output (assuming PORTD)
     DDRD |= (1 << PD0) | (1 << PD1) | (1 << PD2) | (1 << PD3);  // Example pins for motors
     turnOffMotors();  // Ensure motors are off initially
+    dispense_init();  // Timer1 1ms tick that times the pumps
+    clock_init();     // Timer0 1ms system tick for everything else
+    debug_init();     // LCD counter reports on PD4 (Timer2) when built with DEBUG_UART=1
 
     // Enable global interrupts
     sei();
@@ -166,109 +595,146 @@ uint8_t isEncoderPressed(){
 
 // Function to display mode selection
 void displayModes() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("1. Auto Mode");
-    lcd_setCursor(0, 1);
-    lcd_print("2. Manual Mode");
+    lcd_show_screen(SCREEN_MODES);
 }
 
-// Function to display "Processing.." message for 4 seconds
+// Function to display "Processing.." message
 void displayProcessing() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Processing");
-    lcd_setCursor(0, 1);
-    lcd_print("Auto Mode...");
+    lcd_show_screen(SCREEN_PROCESSING_AUTO);
 }
 
 // Function to display "Select the" and "Percentages.." message
 void displayChoosePercentages() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Select the");
-    lcd_setCursor(0, 1);
-    lcd_print("Percentages..");
-}
-
-// Function to display exceeded 100% message
-void displayExceed100() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Exceeded 100%");
-    lcd_setCursor(0, 1);
-    lcd_print("Try again");
-    _delay_ms(4000);
-}
-
-// Function to display a fruit and its percentage in auto mode
-void displayFruitinAuto(char *fruit, uint8_t percentage) {
-    char buffer[16];
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print(fruit);
-    lcd_setCursor(0, 1);
-    snprintf(buffer, sizeof(buffer), "%d%%", percentage);
-    lcd_print(buffer);
+    lcd_show_screen(SCREEN_CHOOSE_PERCENTAGES);
 }
 
-// Function to display a fruit in manual mode
-void displayFruitinManual(char *fruit) {
-    char buffer[16];
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print(fruit);
+// Function to show the 100% rule, scrolled along one row
+void displayTotalLimit() {
+    lcd_fb_clear();
+    lcd_fb_print_P(MSG_AUTO_MODE);
+    marquee_show(0, 1, LCD_COLS, MSG_TOTAL_LIMIT, clock_millis());
+    frameChanged();  // displayTask() scrolls it
+}
+
+// Function to display "Processing.." for manual mode
+void displayProcessingManual() {
+    lcd_show_screen(SCREEN_PROCESSING_MANUAL);
+}
+
+// Function to ask for one fruit
+void displayOneFruit() {
+    lcd_show_screen(SCREEN_ONE_FRUIT);
+}
+
+// Function to draw the four fruits with their percentages into the order
+// row, one LAYOUT_FIELD wide each
+void drawOrderRow() {
+    char buffer[5];
+    for (uint8_t i = 0; i < 4; i++) {
+        lcd_fb_setCursor(i * LAYOUT_FIELD, LAYOUT_ORDER_ROW);
+        lcd_fb_write(glyph_use(fruitIcon(i)));
+        fmt_u16(buffer, percentages[i], 3);
+        lcd_fb_print(buffer);
+    }
+}
+
+// Function to display all four fruits with their percentages and what is
+// left of the 100% budget. On the last fruit the hint offers the fill.
+// A 4 row panel also shows the fruit being edited and a budget bar
+void displayMixEditor() {
+    char buffer[5];
+    uint8_t total = percentageTotal();
+    lcd_fb_clear();
+    drawOrderRow();
+    lcd_fb_setCursor(0, LAYOUT_STATUS_ROW);
+    lcd_fb_print_P(PSTR("Left "));
+    fmt_percent(buffer, 100 - total, 3);
+    lcd_fb_print(buffer);
+    lcd_fb_setCursor(LAYOUT_HINT_COL, LAYOUT_STATUS_ROW);
+    if (editFruit == 3 && total < 100) {
+        lcd_fb_print_P(PSTR("2=Fill"));
+    } else {
+        lcd_fb_print_P(PSTR("1=OK"));
+    }
+#if !LAYOUT_SPLIT
+    marquee_show(0, LAYOUT_DETAIL_ROW, LCD_COLS, fruitName(editFruit), clock_millis());
+    lcd_fb_setCursor(0, LAYOUT_DETAIL_ROW + 1);
+    lcd_fb_bar(LCD_COLS, total, 100);
+#endif
+    lcd_fb_showCursor(editFruit * LAYOUT_FIELD, LAYOUT_ORDER_ROW);  // Underline the fruit being edited
+    frameChanged();
 }
 
-// Function to display "Your order is" and "on the way"
-void displayOrderComplete() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Your order is");
-    lcd_setCursor(0, 1);
-    lcd_print("on the way");
+// Function to display the fruit being edited with its percentage in
+// two-row digits. Only the digits that changed since the last step are sent
+void displayBigPercentage() {
+    lcd_fb_clear();
+    lcd_fb_setCursor(0, LAYOUT_DETAIL_ROW);
+    lcd_fb_write(glyph_use(fruitIcon(editFruit)));
+    lcd_fb_bigNumber(3, LAYOUT_DETAIL_ROW, 3, percentages[editFruit]);
+    lcd_fb_setCursor(LCD_COLS - 1, LAYOUT_DETAIL_ROW + 1);
+    lcd_fb_write('%');
+    frameChanged();
 }
-// Function to display "Press switch 1 to stop"
-void interruptSwitch() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Push Switch 1");
-    lcd_setCursor(0, 1);
-    lcd_print("to stop");
+
+// Function to show an encoder step: the big digits for a moment where the
+// detail replaces the order, otherwise the mix editor has it all. Big
+// digits and four fruit icons need more than the 8 CGRAM slots, so they
+// are never on screen together. Each round trip re-uploads 3 fruit icons
+// (9 LCD writes each, ~3ms in all at 400kHz) plus the segments they
+// evicted, and until the new frame is out the reused slots show the wrong
+// shapes on the old screen
+void displayPercentageStep() {
+#if LAYOUT_SPLIT
+    bigView = 1;
+    bigViewAt = clock_millis();
+    displayBigPercentage();
+#else
+    displayMixEditor();
+#endif
 }
 
+// Function to display a fruit in manual mode
+void displayFruitinManual(uint8_t fruit) {
+    lcd_fb_clear();
+    lcd_fb_setCursor(0, 0);
+    lcd_fb_write(glyph_use(fruitIcon(fruit)));
+    marquee_show(2, 0, LCD_COLS - 2, fruitName(fruit), clock_millis());  // Long names scroll
+    frameChanged();
+}
+
+// Function to display the running pump's progress, the whole order's
+// progress and the seconds left. A 4 row panel shows the order and the
+// name of the fruit being poured above them
+void displayDispenseProgress(uint8_t motor, uint16_t pumpTime, uint16_t left) {
+    char buffer[5];
+    uint16_t done = dispenseDone + pumpTime - left;
+    lcd_fb_clear();
+#if !LAYOUT_SPLIT
+    drawOrderRow();
+    marquee_show(0, LAYOUT_STATUS_ROW, LCD_COLS, fruitName(motor), clock_millis());
+#endif
+    lcd_fb_setCursor(0, LAYOUT_DETAIL_ROW);
+    lcd_fb_write(glyph_use(fruitIcon(motor)));
+    lcd_fb_setCursor(2, LAYOUT_DETAIL_ROW);
+    lcd_fb_bar(LAYOUT_PUMP_BAR, pumpTime - left, pumpTime);
+    lcd_fb_setCursor(0, LAYOUT_DETAIL_ROW + 1);
+    lcd_fb_bar(LAYOUT_TOTAL_BAR, done, dispenseTotal);
+    lcd_fb_setCursor(LAYOUT_ETA_COL, LAYOUT_DETAIL_ROW + 1);
+    fmt_u16(buffer, (dispenseTotal - done + 999) / 1000, 3);
+    lcd_fb_print(buffer);
+    lcd_fb_write('s');
+    frameChanged();  // Usually just the bar's leading cell and the countdown
+}
 
 // Function to display "Enjoy" and "Your drink"
 void displayEnjoyDrink() {
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Enjoy");
-    lcd_setCursor(0, 1);
-    lcd_print("Your drink");
-    _delay_ms(4000);
-}
-
-// Function to check the total percentage
-void checkPercentageSum() {
-    uint8_t total = percentages[0] + percentages[1] + percentages[2] + percentages[3];
-    if (total > 100) {
-        displayExceed100();  // If total exceeds 100%, allow re-selection
-        fruitIndex = 0;  // Reset to the first fruit
-        percentage = 0;
-        displayFruitinAuto(fruits[fruitIndex], percentage);
-        selectingPercentage = 1;  // Re-enable encoder for selection
-	autoSelection();
-    } else {
-        displayOrderComplete();  // If total is valid, display order message
-        for (uint8_t i = 0; i < 4; i++) {
-            turnOnMotor(i, percentages[i]);  // Turn on motors based on percentages
-        }
+    lcd_show_screen(SCREEN_ENJOY_DRINK);
+}
 
-        displayEnjoyDrink();  // Display enjoyment message
-        fruitIndex = 0;  // Reset fruit index for new selection
-        percentages[0] = percentages[1] = percentages[2] = percentages[3] = 0;  // Reset percentages
-       
-    }
+// Function to add up the selected percentages
+uint8_t percentageTotal() {
+    return percentages[0] + percentages[1] + percentages[2] + percentages[3];
 }
 
 // Function to read rotary encoder rotation
@@ -288,21 +754,6 @@ int8_t readEncoder() {
     return 0;  // No rotation
 }
 
-// Function to turn on the specified motor based on percentage
-void turnOnMotor(uint8_t motor, uint8_t percentage) {
-    if (percentage > 0) {  // Only turn on if percentage is greater than 0
-        uint16_t delayTime = getDelayForPercentage(percentage);
-        PORTD &= ~(1 << motor);  // Turn on the motor
-
-        // Use a loop for delay instead of _delay_ms directly
-        while (delayTime > 0 && !stopManualMode) {
-            _delay_ms(1);  // Delay in 1 ms increments
-            delayTime--;  // Decrease delayTime
-        }
-
-        PORTD |= (1 << motor);  // Turn off the motor after delay
-    }
-}
 
 // Function to turn off all motors
 void turnOffMotors() {
@@ -322,88 +773,11 @@ uint16_t getDelayForPercentage(uint8_t percentage) {
     }
 }
 
-// Function for Manual Mode
-void manualMode() {
-   
-
-
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Processing");
-    lcd_setCursor(0, 1);
-    lcd_print("Manual Mode...");
-    _delay_ms(4000);
-
-    lcd_clear();
-    lcd_setCursor(0, 0);
-    lcd_print("Select only");
-    lcd_setCursor(0, 1);
-    lcd_print("One Fruit!");
-    _delay_ms(4000);
-    
-    uint8_t selectedFruitIndex = 0; // Index for the currently selected fruit
-    uint8_t fruitSelected = 0;       // Flag to check if a fruit is selected
-
-    // Main loop for manual mode
-    while (1) {
-        // Display the currently selected fruit
-        displayFruitinManual(fruits[selectedFruitIndex]);
-        
-        // Read the rotary encoder to switch between fruits
-        int8_t rotation = readEncoder();
-        if (rotation > 0) {
-            // Rotate clockwise to select the next fruit
-            selectedFruitIndex++;
-            if (selectedFruitIndex >= 4) {
-                selectedFruitIndex = 0; // Wrap around
-            }
-            _delay_ms(200); // Debounce delay
-        } else if (rotation < 0) {
-            // Rotate counterclockwise to select the previous fruit
-            if (selectedFruitIndex == 0) {
-                selectedFruitIndex = 3; // Wrap around
-            } else {
-                selectedFruitIndex--;
-            }
-            _delay_ms(200); // Debounce delay
-        }
-
-        // Check if the rotary encoder switch is pressed to confirm selection
-        if (isSwitch3Pressed()) {
-            _delay_ms(50); // Debounce delay
-            if (isSwitch3Pressed()) { // Confirm switch press after delay
-                // Activate the selected fruit
-                percentages[selectedFruitIndex] = 100; // Example: Set percentage to 100%
-                turnOnMotor(selectedFruitIndex, percentages[selectedFruitIndex]); // Turn on the selected fruit motor
-        	interruptSwitch();
-                fruitSelected = 1; // Set flag to indicate fruit is selected
-                break; // Exit manual mode loop
-            }
-        }
-
-        // Check if stop switch (PC2) is pressed
-        if (stopManualMode) {
-            turnOffMotors();  // Ensure all motors are turned off
-            break;  // Exit manual mode loop
-        }
-
-        _delay_ms(50); // Small delay for debouncing
-    }
-
-    // After fruit selection or stop
-    if (fruitSelected) {
-         // Display order message
-        displayEnjoyDrink();      // Display enjoy message
-    }
-    
-    // Return to mode selection or reset for another manual selection
-    fruitIndex = 0;  // Reset fruit index for new selection
-    percentages[0] = percentages[1] = percentages[2] = percentages[3] = 0;  // Reset percentages
-}
-
 // Interrupt service routine for handling PC2 (Switch 3)
 ISR(PCINT1_vect) {
     if (isEncoderPressed()) {
         stopManualMode = 1;  // Set flag to indicate stop
+        task_signal(&tasks[TASK_DISPENSE]);
+        task_signal(&tasks[TASK_UI]);
     }
 }
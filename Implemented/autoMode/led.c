@@ -2,6 +2,7 @@
 #include <avr/io.h>
 #include <util/delay.h>
 #include "LCD.h"
+#include "../Final Code/Format.h"
 
 // Function prototypes
 void setup();
@@ -165,7 +166,7 @@ void displayFruit(char *fruit, uint8_t percentage) {
     lcd_setCursor(0, 0);
     lcd_print(fruit);
     lcd_setCursor(0, 1);
-    snprintf(buffer, sizeof(buffer), "%d%%", percentage);
+    fmt_percent(buffer, percentage, 0);
     lcd_print(buffer);
 }
 
@@ -1,7 +1,9 @@
 #define F_CPU 1000000
+#define I2C_SCL_HZ 50000   // 1MHz clock tops out at 62.5kHz SCL
 #include <avr/io.h>
 #include <util/delay.h>
 #include "LCD.h"
+#include "../Final Code/Format.h"
 
 // Function prototypes
 void setup();
@@ -150,7 +152,7 @@ void displayFruit(char *fruit, uint8_t percentage) {
     lcd_setCursor(0, 0);
     lcd_print(fruit);
     lcd_setCursor(0, 1);
-    snprintf(buffer, 16, "%d%%", percentage);
+    fmt_percent(buffer, percentage, 0);
     lcd_print(buffer);
 }
 
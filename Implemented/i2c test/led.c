@@ -1,4 +1,5 @@
 #define F_CPU 1000000
+#define I2C_SCL_HZ 50000   // 1MHz clock tops out at 62.5kHz SCL
 #include <avr/io.h>           /* Include AVR standard library file */
 #include <util/delay.h>       /* Include Delay header file */
 #include "LCD.h"              /* Include your I2C LCD header file */
@@ -0,0 +1,113 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "../../Implemented/Final Code/Glyph.h"     // LCD driver, framebuffer, glyphs
+#include "../../Implemented/Final Code/Format.h"
+#include "../../Implemented/Final Code/Dispense.h"  // Timer1 pump timing
+
+#define RUNS 8          // Pours per mode
+#define POUR_MS 2180    // A 20% pour
+
+// Relay edges on PD0, timestamped in Timer1 ticks by PCINT2
+volatile uint32_t edgeOn = 0;
+volatile uint32_t edgeOff = 0;
+volatile uint8_t edgeCount = 0;
+
+// Function prototypes
+uint16_t measureJitter(uint8_t live);
+void drawProgress(uint16_t left);
+void printResult(uint8_t row, const char *label, uint16_t ticks);
+
+int main(void) {
+    uint16_t quiet;
+    uint16_t live;
+
+    DDRD |= (1 << PD0);              // Relay 1
+    PORTD |= (1 << PD0);             // Off (active low)
+    PCICR |= (1 << PCIE2);           // Pin change interrupt on the relay pin,
+    PCMSK2 |= (1 << PCINT16);        // it also fires for output pins
+    dispense_init();
+    sei();
+
+    initialize();
+    lcd_fb_init();
+    glyph_reset();
+
+    while (1) {
+        quiet = measureJitter(0);    // LCD idle while pouring
+        live = measureJitter(1);     // Progress bar redrawn while pouring
+
+        lcd_fb_clear();
+        printResult(0, "Quiet", quiet);
+        printResult(1, "Live", live);
+        lcd_render();
+        _delay_ms(5000);
+    }
+
+    return 0;
+}
+
+ISR(PCINT2_vect) {
+    uint32_t now = dispense_timestamp();
+    if (PIND & (1 << PD0)) {
+        edgeOff = now;               // Relay released
+        edgeCount++;
+    } else {
+        edgeOn = now;                // Relay energized
+    }
+}
+
+// Pour RUNS times and return the spread (max - min) of the relay on-time
+uint16_t measureJitter(uint8_t live) {
+    uint32_t shortest = 0xFFFFFFFF;
+    uint32_t longest = 0;
+    uint16_t left;
+
+    for (uint8_t run = 0; run < RUNS; run++) {
+        uint8_t seen = edgeCount;
+        dispense_start(PD0, POUR_MS);
+        while ((left = dispense_left()) > 0) {
+            if (live) {
+                drawProgress(left);
+            }
+        }
+        while (edgeCount == seen);   // Wait for the off edge to be stamped
+
+        uint32_t onTime = edgeOff - edgeOn;
+        if (onTime < shortest) {
+            shortest = onTime;
+        }
+        if (onTime > longest) {
+            longest = onTime;
+        }
+        _delay_ms(100);
+    }
+    return longest - shortest;
+}
+
+// Same work per pass as displayDispenseProgress() in the kiosk firmware
+void drawProgress(uint16_t left) {
+    char buffer[5];
+    lcd_fb_clear();
+    lcd_fb_setCursor(0, 0);
+    lcd_fb_bar(16, POUR_MS - left, POUR_MS);
+    lcd_fb_setCursor(0, 1);
+    lcd_fb_bar(11, POUR_MS - left, POUR_MS);
+    lcd_fb_setCursor(12, 1);
+    fmt_u16(buffer, (left + 999) / 1000, 3);
+    lcd_fb_print(buffer);
+    lcd_fb_write('s');
+    lcd_render();
+}
+
+// "Quiet jit   12us": on-time spread over RUNS pours in microseconds
+void printResult(uint8_t row, const char *label, uint16_t ticks) {
+    char buffer[7];
+    lcd_fb_setCursor(0, row);
+    lcd_fb_print(label);
+    lcd_fb_setCursor(6, row);
+    lcd_fb_print_P(PSTR("jit "));
+    fmt_u32(buffer, ticks * 1000UL / DISPENSE_TICKS_PER_MS, 4);
+    lcd_fb_print(buffer);
+    lcd_fb_print_P(PSTR("us"));
+}
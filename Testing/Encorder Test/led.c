@@ -1,9 +1,10 @@
+#define F_CPU 1000000UL   // Set CPU frequency to 1 MHz, before i2c.h sets up the bus
+#define I2C_SCL_HZ 50000  // 1MHz clock tops out at 62.5kHz SCL
 #include <avr/io.h>
 #include <util/delay.h>
 #include <avr/interrupt.h>
 #include "i2c.h"  // Include I2C LCD header file
-
-#define F_CPU 1000000UL   // Set CPU frequency to 1 MHz
+#include "../../Implemented/Final Code/Format.h"
 
 #define encClk PB1      // CLK pin of the rotary encoder (PB1)
 #define encDT PB3       // DT pin of the rotary encoder (PB3)
@@ -14,6 +15,8 @@
 
 volatile int position = 0;  // Tracks the position of the rotary encoder (0 to 5, representing 0% to 100%)
 volatile int percentage = 0;  // Holds the percentage value
+volatile uint8_t valueChanged = 0;  // Set by the ISRs, the main loop redraws and clears it
+uint16_t redraws = 0;  // Redraws done, a fast spin should add one, not one per edge
 
 // Function prototypes
 void setup();
@@ -27,11 +30,23 @@ int main(void) {
     LCD_Init();  // Initialize I2C LCD
     LCD_Clear();  // Clear the LCD
     LCD_String("Value: ");  // Display "Value: " initially on the first line
+    updateLCDValue(0);
 
     sei();  // Enable global interrupts
 
     while (1) {
-        // Main loop can be left empty as everything is handled by the ISRs
+        // The ISRs only record the change; the LCD is written here, where
+        // I2C and delays do not hold off encoder edges. Edges that arrive
+        // during a redraw just set the flag again, so however fast the knob
+        // turns the display costs one redraw per pass with the latest value
+        if (valueChanged) {
+            int value;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                value = percentage;
+                valueChanged = 0;
+            }
+            updateLCDValue(value);
+        }
     }
 
     return 0;
@@ -112,24 +127,26 @@ void rotaryEncISR() {
             break;
     }
 
-    updateLCDValue(percentage);  // Update LCD with the new percentage
+    valueChanged = 1;  // The main loop updates the LCD
 }
 
 void buttonISR() {
     // Reset the rotary encoder to the 0% position on button press
     position = 0;
     percentage = 0;
-    updateLCDValue(percentage);  // Reset percentage on the LCD
+    valueChanged = 1;  // Reset percentage on the LCD
 }
 
+// Main loop only, never from an ISR
 void updateLCDValue(int value) {
-    char buffer[5];
-    snprintf(buffer, 5, "%d%%", value);  // Format the value as percentage
+    char buffer[7];
+    fmt_percent(buffer, value, 4);  // Right aligned, overwrites the old value
     
     LCD_SetCursor(1, 0);  // Move the cursor to the second line of the LCD
-    LCD_String("            ");  // Clear the second line (16 characters)
-    
-    LCD_SetCursor(1, 0);  // Set cursor to the beginning of the second line again
     LCD_String(buffer);   // Display the percentage value
+
+    fmt_u16(buffer, ++redraws, 6);
+    LCD_SetCursor(1, 10); // Redraw count on the right
+    LCD_String(buffer);
 }
 
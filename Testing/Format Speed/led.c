@@ -0,0 +1,82 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <stdio.h>
+#include "../../Implemented/Final Code/LCDBuffer.h"  // LCD driver and framebuffer
+#include "../../Implemented/Final Code/Format.h"
+
+// Function prototypes
+uint16_t timePrintf(void);
+uint16_t timeFormat(void);
+void showResult(uint8_t row, const char *label, uint16_t cycles);
+
+char out[8];  // Where both formatters write, global so nothing is optimised away
+
+int main(void) {
+    uint16_t printfCycles;
+    uint16_t formatCycles;
+
+    TCCR1A = 0;
+    TCCR1B = (1 << CS10);        // Timer1 counts CPU cycles
+    sei();
+
+    initialize();
+    lcd_fb_init();
+
+    while (1) {
+        printfCycles = timePrintf();
+        formatCycles = timeFormat();
+        lcd_fb_clear();
+        showResult(0, PSTR("printf"), printfCycles);
+        showResult(1, PSTR("fmt_*"), formatCycles);
+        lcd_render();
+        _delay_ms(2000);
+    }
+
+    return 0;
+}
+
+// Worst case over 0-100% of the mix editor's "Left %3u%%"
+uint16_t timePrintf(void) {
+    uint16_t worst = 0;
+    for (uint8_t v = 0; v <= 100; v++) {
+        uint16_t cycles;
+        cli();
+        TCNT1 = 0;
+        snprintf_P(out, sizeof(out), PSTR("%3u%%"), v);
+        cycles = TCNT1;
+        sei();
+        if (cycles > worst) {
+            worst = cycles;
+        }
+    }
+    return worst;
+}
+
+// The same with Format.h
+uint16_t timeFormat(void) {
+    uint16_t worst = 0;
+    for (uint8_t v = 0; v <= 100; v++) {
+        uint16_t cycles;
+        cli();
+        TCNT1 = 0;
+        fmt_percent(out, v, 3);
+        cycles = TCNT1;
+        sei();
+        if (cycles > worst) {
+            worst = cycles;
+        }
+    }
+    return worst;
+}
+
+// "printf   1530cyc"
+void showResult(uint8_t row, const char *label, uint16_t cycles) {
+    char buffer[7];
+    lcd_fb_setCursor(0, row);
+    lcd_fb_print_P(label);
+    lcd_fb_setCursor(7, row);
+    fmt_u16(buffer, cycles, 6);
+    lcd_fb_print(buffer);
+    lcd_fb_print_P(PSTR("cyc"));
+}
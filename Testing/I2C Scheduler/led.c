@@ -0,0 +1,77 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "../../Implemented/Final Code/Clock.h"     // Timer0 ticks for the latencies
+
+#define I2C_CLOCK() clock_ticks()
+#define I2C_CLOCK_CYCLES 64
+
+#include "../../Implemented/Final Code/LCDBuffer.h" // LCD driver, bus and framebuffer
+#include "../../Implemented/Final Code/Format.h"
+
+// Second PCF8574 on the bus standing in for the cup sensor, switch from P0
+// to GND (A0-A2 to GND)
+#define SENSOR_ADDR 0x20
+
+uint8_t sensorPins;
+i2c_txn_t sensorRead = {0, SENSOR_ADDR, I2C_PRIO_SAFETY, 0, 0, &sensorPins, 1};
+
+// Function prototypes
+void drawStatus(uint16_t pass);
+
+int main(void) {
+    uint16_t pass = 0;
+    uint32_t readAt = 0;
+
+    clock_init();
+    sei();
+
+    lcd_skip |= LCD_ADDR_BIT(SENSOR_ADDR); // Never take the sensor for the display
+    initialize();
+    lcd_fb_init();
+
+    sensorPins = 0xFF;
+    i2c_submit(&sensorRead);
+
+    while (1) {
+        // Read the sensor every 10ms, alongside whatever the display is doing
+        if (sensorRead.status != I2C_PENDING && clock_elapsed(readAt, 10)) {
+            readAt = clock_millis();
+            i2c_submit(&sensorRead);
+        }
+        drawStatus(pass++);
+        lcd_render();                // ~40 bytes queued every pass
+        lcd_fb_keepalive();
+    }
+
+    return 0;
+}
+
+// Worst latency of the sensor reads and how many took 100us or more, the
+// cup switch, and a counter pattern that changes ten cells each pass so the
+// display stream never runs dry
+void drawStatus(uint16_t pass) {
+    char line[11];
+    uint32_t max;
+    uint16_t slow = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        max = i2c_lat_max[I2C_PRIO_SAFETY];
+        for (uint8_t b = 2; b < I2C_HIST_BUCKETS; b++) {
+            slow += i2c_hist[I2C_PRIO_SAFETY][b];
+        }
+    }
+    lcd_fb_clear();
+    lcd_fb_print_P(PSTR("Max "));
+    fmt_u32(line, max * CLOCK_US_PER_TICK, 4);
+    lcd_fb_print(line);
+    lcd_fb_print_P(PSTR("us >"));
+    fmt_u16(line, slow, 4);
+    lcd_fb_print(line);
+    lcd_fb_setCursor(0, 1);
+    lcd_fb_print((sensorPins & 0x01) ? "Cup -" : "Cup Y");
+    lcd_fb_setCursor(6, 1);
+    for (uint8_t c = 6; c < LCD_COLS; c++) {
+        lcd_fb_write('0' + (pass + c) % 10);
+    }
+}
@@ -0,0 +1,246 @@
+// Host side of the LCD benchmark: runs led.elf in simavr with a PCF8574
+// backpack and HD44780 on the TWI bus, and prints one CSV row per
+// measurement the firmware marks in GPIOR0 (see led.c and the readme).
+//
+//   lcdsim led.elf <f_cpu> <scl_hz> <variant>
+//
+// Built by "make lcdsim" against an installed simavr (libsimavr, libelf)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_avr.h"     // simavr, include dir set in the Makefile
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "avr_twi.h"
+
+#define GPIOR0_ADDR 0x3E      // Data space addresses on the ATmega328P
+#define GPIOR1_ADDR 0x4A
+
+#define LCD_ADDR 0x27         // Where lcd_detect() looks first
+
+#define PIN_RS 0x01           // PCF8574 bits, as in LCD.h
+#define PIN_RW 0x02
+#define PIN_E  0x04
+
+#define SIM_SECONDS 60        // Simulated time before giving up
+
+// PCF8574 latch and the HD44780 behind it, as far as timing goes: the
+// 4-bit interface, the address counter, DDRAM and the busy time of each
+// instruction. An instruction latched while the previous one is still
+// executing counts as late (the real display would drop or garble it)
+typedef struct lcd_model {
+    avr_t *avr;
+    avr_irq_t *irq;           // TWI_IRQ_INPUT and TWI_IRQ_OUTPUT
+    uint8_t selected;         // Address byte (with R/W) while addressed, else 0
+    uint8_t pins;             // PCF8574 output latch
+    uint8_t eight_bit;        // Interface width, 8-bit after power up
+    uint8_t have_high;        // First nibble of a 4-bit byte received
+    uint8_t high;
+    uint8_t read_low;         // Next busy flag read returns the low nibble
+    uint8_t ac;               // Address counter
+    char ddram[0x80];
+    avr_cycle_count_t busy_until;
+    uint32_t executed;        // Instructions and characters
+    uint32_t late;
+} lcd_model_t;
+
+// One measurement from GPIOR0 marks
+typedef struct bench {
+    avr_t *avr;
+    lcd_model_t *lcd;
+    const char *config;       // "f_cpu,scl_hz,variant" for every row
+    uint8_t test;             // Running measurement, 0 = none
+    uint8_t done;
+    avr_cycle_count_t start;
+    uint32_t executed;
+    uint32_t late;
+} bench_t;
+
+static const char *test_names[] = {"", "char", "string", "redraw", "clear"};
+
+// Run one instruction or character. The display is then busy for the
+// datasheet execution time (270kHz oscillator)
+static void lcd_exec(lcd_model_t *p, uint8_t byte, uint8_t rs) {
+    uint32_t us = 37;
+
+    if (p->avr->cycle < p->busy_until) {
+        p->late++;
+    }
+    p->executed++;
+    if (rs) {
+        p->ddram[p->ac & 0x7F] = byte;
+        p->ac = p->ac == 0x27 ? 0x40 : p->ac == 0x67 ? 0x00 : p->ac + 1;
+        us = 41;
+    } else if (byte == 0x01) {
+        memset(p->ddram, ' ', sizeof(p->ddram));
+        p->ac = 0;
+        us = 1520;
+    } else if ((byte & 0xFE) == 0x02) {
+        p->ac = 0;
+        us = 1520;
+    } else if (byte & 0x80) {
+        p->ac = byte & 0x7F;
+    } else if ((byte & 0xE0) == 0x20) {
+        p->eight_bit = (byte & 0x10) != 0;  // Function set
+        p->have_high = 0;
+    }
+    p->busy_until = p->avr->cycle + (avr_cycle_count_t)us * p->avr->frequency / 1000000;
+}
+
+// The HD44780 latches D4-D7 on the falling edge of E
+static void lcd_latch(lcd_model_t *p, uint8_t pins) {
+    uint8_t nibble = pins >> 4;
+
+    if (pins & PIN_RW) {
+        p->read_low = !p->read_low;         // A read pulse, next nibble
+    } else if (p->eight_bit) {
+        lcd_exec(p, nibble << 4, pins & PIN_RS);
+    } else if (!p->have_high) {
+        p->high = nibble;
+        p->have_high = 1;
+    } else {
+        p->have_high = 0;
+        lcd_exec(p, (p->high << 4) | nibble, pins & PIN_RS);
+    }
+}
+
+// Pins as the PCF8574 reads them back: its outputs are weak pull ups, so
+// with E and RW high the HD44780 pulls D4-D7 down to the busy flag and
+// address counter, one nibble per E pulse
+static uint8_t lcd_pins_read(lcd_model_t *p) {
+    uint8_t status;
+    uint8_t nibble;
+
+    if ((p->pins & (PIN_E | PIN_RW | PIN_RS)) != (PIN_E | PIN_RW)) {
+        return p->pins;
+    }
+    status = (p->avr->cycle < p->busy_until ? 0x80 : 0) | (p->ac & 0x7F);
+    nibble = p->read_low ? status & 0x0F : status >> 4;
+    return p->pins & ((nibble << 4) | 0x0F);
+}
+
+// TWI messages from the AVR, as in simavr's i2c_eeprom part
+static void lcd_twi_hook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    lcd_model_t *p = (lcd_model_t *)param;
+    avr_twi_msg_irq_t v;
+    v.u.v = value;
+
+    if (v.u.twi.msg & TWI_COND_STOP) {
+        p->selected = 0;
+    }
+    if (v.u.twi.msg & TWI_COND_START) {
+        p->selected = 0;
+        if ((v.u.twi.addr >> 1) == LCD_ADDR) {
+            p->selected = v.u.twi.addr;
+            avr_raise_irq(p->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, p->selected, 1));
+        }
+    }
+    if (!p->selected) {
+        return;
+    }
+    if (v.u.twi.msg & TWI_COND_WRITE) {
+        uint8_t old = p->pins;
+        avr_raise_irq(p->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, p->selected, 1));
+        p->pins = v.u.twi.data;
+        if ((old & PIN_E) && !(p->pins & PIN_E)) {
+            lcd_latch(p, old);
+        }
+    }
+    if (v.u.twi.msg & TWI_COND_READ) {
+        avr_raise_irq(p->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, p->selected, lcd_pins_read(p)));
+    }
+}
+
+static void lcd_model_init(lcd_model_t *p, avr_t *avr) {
+    static const char *irq_names[2] = {
+        [TWI_IRQ_INPUT] = "8>lcd.out",
+        [TWI_IRQ_OUTPUT] = "32<lcd.in",
+    };
+
+    memset(p, 0, sizeof(*p));
+    p->avr = avr;
+    p->pins = 0xFF;                         // PCF8574 power up state
+    p->eight_bit = 1;
+    memset(p->ddram, ' ', sizeof(p->ddram));
+    p->irq = avr_alloc_irq(&avr->irq_pool, 0, 2, irq_names);
+    avr_irq_register_notify(p->irq + TWI_IRQ_OUTPUT, lcd_twi_hook, p);
+    avr_connect_irq(p->irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+    avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), p->irq + TWI_IRQ_OUTPUT);
+}
+
+// CSV row: f_cpu,scl_hz,variant,test,ops,cycles,us_per_op,late,status
+static void bench_row(bench_t *b, uint8_t ops, avr_cycle_count_t cycles, const char *status) {
+    double us = ops ? (double)cycles * 1000000.0 / b->avr->frequency / ops : 0;
+    printf("%s,%s,%u,%llu,%.1f,%lu,%s\n", b->config, test_names[b->test], ops,
+           (unsigned long long)cycles, us, (unsigned long)(b->lcd->late - b->late), status);
+}
+
+// GPIOR0 written: a test number starts a measurement, 0 ends it
+static void bench_mark(struct avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+    bench_t *b = (bench_t *)param;
+
+    avr->data[addr] = v;
+    if (v == 0xFF) {
+        b->done = 1;
+    } else if (v == 0 && b->test) {
+        uint8_t ops = avr->data[GPIOR1_ADDR];
+        bench_row(b, ops, avr->cycle - b->start, b->lcd->executed == b->executed ? "nolcd" : "ok");
+        b->test = 0;
+    } else if (v > 0 && v < sizeof(test_names) / sizeof(test_names[0])) {
+        b->test = v;
+        b->start = avr->cycle;
+        b->executed = b->lcd->executed;
+        b->late = b->lcd->late;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    elf_firmware_t f;
+    avr_t *avr;
+    lcd_model_t lcd;
+    bench_t bench;
+    char config[64];
+    unsigned long f_cpu;
+    int state = cpu_Running;
+
+    if (argc != 5) {
+        fprintf(stderr, "usage: %s led.elf f_cpu scl_hz variant\n", argv[0]);
+        return 2;
+    }
+    f_cpu = strtoul(argv[2], NULL, 10);
+    snprintf(config, sizeof(config), "%lu,%s,%s", f_cpu, argv[3], argv[4]);
+
+    memset(&f, 0, sizeof(f));
+    if (elf_read_firmware(argv[1], &f)) {
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    strcpy(f.mmcu, "atmega328p");
+    f.frequency = f_cpu;
+    avr = avr_make_mcu_by_name(f.mmcu);
+    if (!avr) {
+        return 1;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &f);
+
+    lcd_model_init(&lcd, avr);
+    memset(&bench, 0, sizeof(bench));
+    bench.avr = avr;
+    bench.lcd = &lcd;
+    bench.config = config;
+    avr_register_io_write(avr, GPIOR0_ADDR, bench_mark, &bench);
+
+    while (!bench.done && avr->cycle < (avr_cycle_count_t)SIM_SECONDS * f_cpu) {
+        state = avr_run(avr);
+        if (state == cpu_Done || state == cpu_Crashed) {
+            break;
+        }
+    }
+    if (!bench.done) {
+        bench_row(&bench, 0, 0, state == cpu_Crashed ? "crashed" : "timeout");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "../../Implemented/Final Code/LCDBuffer.h" // LCD driver, bus and framebuffer
+
+#if LCD_COLS != 16 || LCD_ROWS != 2
+#error "The benchmark is written for the 16x2 panel"
+#endif
+
+// Runs under lcdsim (see readme), which counts the CPU cycles between the
+// marks this sketch writes to GPIOR0: the test number when a measurement
+// starts, 0 when it ends, BENCH_DONE after the last one. GPIOR1 holds how
+// many operations the measurement covered. On real hardware the marks do
+// nothing and the screens just flicker past
+#define BENCH_CHAR   1   // One character per transaction, LCD_Char() and lcd_flush()
+#define BENCH_STRING 2   // Characters streamed in one transaction, lcd_print()
+#define BENCH_REDRAW 3   // Every cell changed, lcd_render()
+#define BENCH_CLEAR  4   // lcd_clear()
+#define BENCH_DONE   0xFF
+
+#define BENCH_REPEAT 8   // Operations per measurement for redraw and clear
+
+// Function prototypes
+void benchStart(uint8_t test, uint8_t ops);
+void benchEnd(void);
+void fillFrame(char first);
+
+int main(void) {
+    sei();                  // The async backend needs TWI_vect
+
+    initialize();
+    lcd_fb_init();
+
+    // Per character, each one its own START..STOP. The async backend would
+    // merge back to back LCD_Char()s into the open transaction, so wait for
+    // each one to go out first
+    benchStart(BENCH_CHAR, LCD_COLS * 2);
+    lcd_setCursor(0, 0);
+    for (uint8_t i = 0; i < LCD_COLS * 2; i++) {
+        LCD_Char('A' + i % 26);
+        lcd_flush();
+    }
+    benchEnd();
+
+    // Per character, one transaction per row
+    benchStart(BENCH_STRING, LCD_COLS * 2);
+    for (uint8_t r = 0; r < 2; r++) {
+        lcd_setCursor(0, r);
+        lcd_print("0123456789ABCDEF");
+    }
+    lcd_flush();
+    benchEnd();
+
+    // Full screen, alternating frames so every cell is dirty each time
+    lcd_fb_clear();
+    lcd_render();
+    lcd_flush();
+    benchStart(BENCH_REDRAW, BENCH_REPEAT);
+    for (uint8_t i = 0; i < BENCH_REPEAT; i++) {
+        fillFrame((i & 1) ? 'a' : 'A');
+        lcd_render();
+    }
+    lcd_flush();
+    benchEnd();
+
+    benchStart(BENCH_CLEAR, BENCH_REPEAT);
+    for (uint8_t i = 0; i < BENCH_REPEAT; i++) {
+        lcd_clear();
+    }
+    lcd_flush();
+    benchEnd();
+
+    GPIOR0 = BENCH_DONE;
+    while (1) {
+    }
+
+    return 0;
+}
+
+void benchStart(uint8_t test, uint8_t ops) {
+    GPIOR1 = ops;
+    GPIOR0 = test;
+}
+
+void benchEnd(void) {
+    GPIOR0 = 0;
+}
+
+// Letters from `first` on, a different one in every cell
+void fillFrame(char first) {
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        lcd_fb_setCursor(0, r);
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            lcd_fb_write(first + (r * LCD_COLS + c) % 26);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "../../Implemented/Final Code/LCDBuffer.h"  // LCD driver and framebuffer
+#include "../../Implemented/Final Code/Format.h"
+
+// Longest lcd_render() seen, in Timer1 ticks of 4us
+uint16_t maxTicks = 0;
+
+// Function prototypes
+void setupTimer(void);
+void drawStatus(uint16_t pass);
+
+int main(void) {
+    uint16_t pass = 0;
+    uint16_t ticks;
+
+    setupTimer();
+    sei();
+
+    initialize();
+    lcd_fb_init();
+
+    while (1) {
+        lcd_fb_keepalive();          // Catches a swapped or browned out display
+        drawStatus(pass++);
+        TCNT1 = 0;
+        lcd_render();
+        ticks = TCNT1;
+        if (ticks > maxTicks) {
+            maxTicks = ticks;
+        }
+        _delay_ms(50);
+    }
+
+    return 0;
+}
+
+// Timer1 free running at F_CPU/64 (4us per tick at 16MHz)
+void setupTimer(void) {
+    TCCR1A = 0;
+    TCCR1B = (1 << CS11) | (1 << CS10);
+}
+
+// Worst render time so far, the driver's fault counters and a counter that
+// changes every pass so each render has something to send
+void drawStatus(uint16_t pass) {
+    char line[11];
+
+    lcd_fb_clear();
+    lcd_fb_print_P(PSTR("Max "));
+    fmt_u32(line, maxTicks * 4UL, 6);
+    lcd_fb_print(line);
+    lcd_fb_print_P(PSTR("us "));
+    fmt_u16(line, pass % 1000, 3);
+    lcd_fb_print(line);
+    lcd_fb_setCursor(0, 1);
+    lcd_fb_write('T');
+    fmt_u16(line, i2c_timeouts, 4);
+    lcd_fb_print(line);
+    lcd_fb_print_P(PSTR(" R"));
+    fmt_u16(line, i2c_recoveries, 4);
+    lcd_fb_print(line);
+    lcd_fb_print_P(PSTR(" I"));
+    fmt_u16(line, lcd_reinits, 3);
+    lcd_fb_print(line);
+}
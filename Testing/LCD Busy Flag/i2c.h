@@ -0,0 +1,16 @@
+#ifndef I2C_H
+#define I2C_H
+
+/* The test sketches share the driver in Implemented/Final Code/LCD.h, which
+   works TWBR and the prescaler out from F_CPU and I2C_SCL_HZ, and keeps the
+   LCD_* names used here. Define F_CPU (and I2C_SCL_HZ for slow clocks, e.g.
+   50000 at 1MHz) before including this file */
+
+/* Blocking backend, these sketches do not enable interrupts */
+#ifndef LCD_TWI_ASYNC
+#define LCD_TWI_ASYNC 0
+#endif
+
+#include "../../Implemented/Final Code/LCD.h"
+
+#endif
@@ -0,0 +1,63 @@
+#include <avr/io.h>
+#include <util/delay.h>
+#include "i2c.h"          // Include the I2C LCD header file
+#include "../../Implemented/Final Code/Format.h"
+
+#define BENCH_PASSES 4    // Each pass clears and rewrites one 16 character row
+
+// Function prototypes
+void setupTimer(void);
+uint16_t benchChars(void);
+
+int main(void) {
+    char line[11];
+    uint16_t fixedTicks;
+    uint16_t busyTicks;
+
+    setupTimer();
+    LCD_Init();
+
+    while (1) {
+        lcd_busy_poll = 0;             // Worst case 2ms after each clear
+        fixedTicks = benchChars();
+
+        lcd_busy_poll = 1;             // Poll the busy flag instead
+        busyTicks = benchChars();
+
+        // 64 characters in N ticks of 64us = 1000000 / N characters per second
+        LCD_Clear();
+        LCD_SetCursor(0, 0);
+        LCD_String("Fixed ");
+        fmt_u32(line, 1000000UL / fixedTicks, 5);
+        LCD_String(line);
+        LCD_String(" c/s");
+        LCD_SetCursor(1, 0);
+        LCD_String("Busy  ");
+        fmt_u32(line, 1000000UL / busyTicks, 5);
+        LCD_String(line);
+        LCD_String(" c/s");
+
+        _delay_ms(5000);
+    }
+
+    return 0;
+}
+
+// Timer1 free running at F_CPU/1024 (64us per tick at 16MHz)
+void setupTimer(void) {
+    TCCR1A = 0;
+    TCCR1B = (1 << CS12) | (1 << CS10);
+}
+
+// Clear and write BENCH_PASSES rows of 16 characters, return the Timer1 ticks
+// taken. Clear is the only command the driver waits on, so it is in the loop
+uint16_t benchChars(void) {
+    TCNT1 = 0;
+    for (uint8_t pass = 0; pass < BENCH_PASSES; pass++) {
+        LCD_Clear();
+        for (uint8_t i = 0; i < 16; i++) {
+            LCD_Char('0' + i % 10);
+        }
+    }
+    return TCNT1;
+}
@@ -0,0 +1,93 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "../../Implemented/Final Code/Marquee.h"   // LCD driver, framebuffer, marquee
+#include "../../Implemented/Final Code/Format.h"
+
+#define PASSES 1000     // Pour screen redraws, several wraps of lcd_fb_clears
+#define PASS_MS 20      // The kiosk redraws the pour screen this often
+
+const char LONG_TEXT[] PROGMEM = "Total must be 100% before ordering";
+
+// Function prototypes
+uint16_t checkPour(void);
+uint8_t checkScroll(void);
+void drawPour(uint16_t pass);
+
+int main(void) {
+    char buffer[6];
+    uint16_t stray;
+    uint8_t scrolls;
+
+    initialize();
+    lcd_fb_init();
+
+    while (1) {
+        stray = checkPour();
+        scrolls = checkScroll();
+
+        lcd_fb_clear();
+        lcd_fb_print_P(stray ? PSTR("Stray ") : PSTR("Pour OK"));
+        if (stray) {
+            fmt_u16(buffer, stray, 5);
+            lcd_fb_print(buffer);
+        }
+        lcd_fb_setCursor(0, 1);
+        lcd_fb_print_P(scrolls ? PSTR("Scroll OK") : PSTR("No scroll"));
+        lcd_render();
+        _delay_ms(5000);
+    }
+
+    return 0;
+}
+
+// A marquee screen, then a pour screen that never starts a marquee,
+// redrawn PASSES times with marquee_tick() after each redraw as the
+// kiosk's display task does. Returns the passes on which row 1 was not
+// what the pour screen drew (the marquee came back), 0 = pass
+uint16_t checkPour(void) {
+    uint16_t now = 0;
+    uint16_t stray = 0;
+
+    lcd_fb_clear();
+    marquee_show(0, 1, LCD_COLS, LONG_TEXT, now);
+
+    for (uint16_t pass = 0; pass < PASSES; pass++) {
+        now += PASS_MS;
+        drawPour(pass);
+        marquee_tick(now);
+        for (uint8_t c = 0; c < LCD_COLS; c++) {
+            if (lcd_frame[1][c] != '0' + (pass + c) % 10) {
+                stray++;
+                break;
+            }
+        }
+    }
+    return stray;
+}
+
+// The marquee still scrolls on its own screen, 1 = it moved
+uint8_t checkScroll(void) {
+    uint16_t now = 0;
+
+    lcd_fb_clear();
+    marquee_show(0, 1, LCD_COLS, LONG_TEXT, now);
+    for (uint8_t i = 0; i < 10; i++) {
+        now += MARQUEE_HOLD_MS / 4;
+        if (marquee_tick(now)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Stand-in for the pour screen: a clear and a pattern on row 1 that
+// changes every pass
+void drawPour(uint16_t pass) {
+    lcd_fb_clear();
+    lcd_fb_print_P(PSTR("Pouring"));
+    lcd_fb_setCursor(0, 1);
+    for (uint8_t c = 0; c < LCD_COLS; c++) {
+        lcd_fb_write('0' + (pass + c) % 10);
+    }
+}
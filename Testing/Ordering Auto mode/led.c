@@ -1,6 +1,7 @@
 #include <avr/io.h>
 #include <util/delay.h>
 #include "i2c.h"          // Include the I2C LCD header file
+#include "../../Implemented/Final Code/Format.h"
 
 // Function prototypes
 void setup();
@@ -120,10 +121,12 @@ void displayChoosePercentages() {
 
 // Function to display fruit name and percentage
 void displayFruit(char *fruit, uint8_t percentage) {
-    char buffer[16];
+    char buffer[5];
     LCD_Clear();                 // Clear the LCD
-    snprintf(buffer, 16, "%s %d%%", fruit, percentage);  // Format string: "Fruit Name XX%"
-    LCD_String(buffer);          // Display the fruit and percentage
+    LCD_String(fruit);           // "Fruit Name XX%"
+    LCD_Char(' ');
+    fmt_percent(buffer, percentage, 0);
+    LCD_String(buffer);          // Display the percentage
 }
 
 // Function to display "Your order is" and "on the way"
@@ -1,7 +1,9 @@
 #define F_CPU 1000000
+#define I2C_SCL_HZ 50000   // 1MHz clock tops out at 62.5kHz SCL
 #include <avr/io.h>
 #include <util/delay.h>
 #include "i2c.h"  // Include the I2C LCD header file
+#include "../../Implemented/Final Code/Format.h"
 
 // Function prototypes
 void setup();
@@ -173,7 +175,7 @@ void displayFruit(char *fruit, uint8_t percentage) {
     LCD_Clear();
     LCD_String(fruit);
     LCD_Command(0xC0);  // Move to the 2nd row
-    snprintf(buffer, 16, "%d%%", percentage);
+    fmt_percent(buffer, percentage, 0);
     LCD_String(buffer);
 }
 
@@ -1,6 +1,7 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include "i2c.h" // Make sure to include the LCD driver library (you should have this configured for AVR)
+#include "../../Implemented/Final Code/Format.h"
 
 #define encClk PD2  // Rotary encoder CLK
 #define encButton PD3 // Rotary encoder button
@@ -9,8 +10,25 @@
 volatile int decCount = 0;
 volatile int onesCount = 0;
 volatile int tensCount = 0;
+volatile uint8_t countChanged = 0; // Set by the ISR, loop() redraws and clears it
 
-void setup() {
+// Function prototypes
+void setup(void);
+void loop(void);
+void countUp(void);
+void countDown(void);
+void updateDisplay(void);
+
+int main(void) {
+    setup();
+    while (1) {
+        loop();
+    }
+
+    return 0;
+}
+
+void setup(void) {
     // Set up pins for rotary encoder
     DDRD &= ~(1 << encClk);   // Set encClk as input
     DDRD &= ~(1 << encButton); // Set encButton as input
@@ -20,20 +38,26 @@ void setup() {
     // Set up interrupts
     EICRA |= (1 << ISC00);    // Set INT0 to trigger on rising edge
     EIMSK |= (1 << INT0);     // Enable external interrupt on INT0
-    sei();                    // Enable global interrupts
 
     // Initialize LCD
-    lcd_init();               // Initialize the LCD
-    lcd_clear();
-    lcd_gotoxy(0, 0);
-    lcd_puts("Value: ");      // Display static label
+    LCD_Init();               // Initialize the LCD
+    LCD_Clear();
+    LCD_SetCursor(0, 0);
+    LCD_String("Value: ");    // Display static label
+
+    LCD_SetCursor(1, 0);
+    LCD_String("000");        // Initialize value display with "000"
 
-    lcd_gotoxy(0, 1);
-    lcd_puts("000");          // Initialize value display with "000"
+    sei();                    // Enable global interrupts
 }
 
-void loop() {
-    // Loop does nothing, everything is handled by interrupts
+void loop(void) {
+    // The ISR only counts; the LCD is written here so I2C never runs with
+    // interrupts off. A burst of edges during one redraw is shown by the
+    // next one, with the latest count
+    if (countChanged) {
+        updateDisplay();
+    }
 }
 
 ISR(INT0_vect) {
@@ -51,7 +75,7 @@ ISR(INT0_vect) {
             countUp();
         }
     }
-    updateDisplay(); // Update the display whenever the encoder is turned
+    countChanged = 1; // loop() updates the display
 }
 
 void countUp(void) {
@@ -84,11 +108,17 @@ void countDown(void) {
     }
 }
 
+// Main loop only, never from an ISR
 void updateDisplay(void) {
     char value[4];
-    snprintf(value, sizeof(value), "%d%d%d", tensCount, onesCount, decCount);  // Convert counts to string
+    uint16_t count;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // The three digits from the same edge
+        count = tensCount * 100 + onesCount * 10 + decCount;
+        countChanged = 0;
+    }
+    fmt_zero(value, count, 3); // Convert counts to string
 
-    lcd_gotoxy(0, 1);          // Move to the second row
-    lcd_puts(value);           // Display the updated value
+    LCD_SetCursor(1, 0);       // Move to the second row
+    LCD_String(value);         // Display the updated value
 }
 